@@ -0,0 +1,102 @@
+#!/bin/sh
+#
+# A/B comparison of two benchmark builds (usually two RocksDB versions,
+# see "make ab"). Runs are interleaved A B A B ... so that drift in the
+# machine (thermal state, page cache, background load) hits both sides
+# equally, then every metric from --report is shown side by side.
+#
+# Usage:
+#   ./ab_compare.sh BIN_A BIN_B [ROUNDS] [benchmark flags...]
+#
+# Every run uses the same --seed ($AB_SEED, default 42) so both sides
+# replay identical workloads; a --seed among the flags overrides it.
+# Per-run reports are kept in $AB_DIR (default: ab_results).
+
+if [ $# -lt 2 ]; then
+    echo "Usage: $0 BIN_A BIN_B [ROUNDS] [benchmark flags...]" >&2
+    exit 1
+fi
+
+BIN_A=$1
+BIN_B=$2
+shift 2
+ROUNDS=3
+case "$1" in
+    ''|*[!0-9]*) ;;
+    *) ROUNDS=$1; shift ;;
+esac
+AB_DIR=${AB_DIR:-ab_results}
+AB_SEED=${AB_SEED:-42}
+
+rm -rf "$AB_DIR"
+mkdir -p "$AB_DIR"
+
+round=1
+while [ "$round" -le "$ROUNDS" ]; do
+    for side in a b; do
+        if [ "$side" = a ]; then bin=$BIN_A; else bin=$BIN_B; fi
+        echo "=== Round $round/$ROUNDS: $side ($bin)"
+        if ! "$bin" --seed="$AB_SEED" "$@" --report="$AB_DIR/$side.$round.tsv" > "$AB_DIR/$side.$round.log" 2>&1; then
+            echo "Run failed, see $AB_DIR/$side.$round.log" >&2
+            exit 1
+        fi
+    done
+    round=$((round + 1))
+done
+
+# A metric counts as changed only if the two sides' ranges over all
+# rounds do not overlap; otherwise the difference is within run noise.
+# Whether a change is better or worse depends on the unit; units with no
+# fixed direction (sizes, counts, percentages) are only marked changed.
+awk -F '\t' '
+    BEGIN {
+        split("ops/sec MB/sec", up, " ")
+        split("sec ms us allocs/batch bytes/key", down, " ")
+        for (i in up) direction[up[i]] = 1
+        for (i in down) direction[down[i]] = -1
+    }
+    FNR == 1 { side = FILENAME; sub(/.*\//, "", side); side = substr(side, 1, 1) }
+    /^#/ {
+        key = substr($1, 2)
+        if (!((side, key) in meta)) meta[side, key] = $2
+        if (!(key in meta_seen)) { meta_seen[key] = 1; meta_keys[++nmeta] = key }
+        next
+    }
+    {
+        m = $1
+        # One key, one number per run; pooling two would average unrelated results
+        if ((FILENAME, m) in in_run) {
+            printf "%s: duplicate metric \"%s\"\n", FILENAME, m > "/dev/stderr"
+            failed = 1
+            exit 1
+        }
+        in_run[FILENAME, m] = 1
+        if (!(m in seen)) { seen[m] = 1; order[++n] = m; unit[m] = $2 }
+        sum[side, m] += $3; cnt[side, m]++
+        if (cnt[side, m] == 1 || $3 < lo[side, m]) lo[side, m] = $3
+        if (cnt[side, m] == 1 || $3 > hi[side, m]) hi[side, m] = $3
+    }
+    END {
+        if (failed) exit 1
+        # Environment in full; of the ~200 options, only those that differ
+        for (i = 1; i <= nmeta; i++) {
+            k = meta_keys[i]
+            if (k ~ /^option\./ && meta["a", k] == meta["b", k]) continue
+            printf "%-14s A: %s\n%-14s B: %s\n", k, meta["a", k], "", meta["b", k]
+        }
+        printf "\n%-60s %-8s %14s %14s %9s  %s\n", "Metric", "Unit", "A (mean)", "B (mean)", "B vs A", ""
+        for (i = 1; i <= n; i++) {
+            m = order[i]
+            if (!cnt["a", m] || !cnt["b", m]) continue
+            a = sum["a", m] / cnt["a", m]
+            b = sum["b", m] / cnt["b", m]
+            delta = a != 0 ? 100 * (b - a) / a : 0
+            verdict = "~"
+            if (lo["b", m] > hi["a", m] || hi["b", m] < lo["a", m]) {
+                if (!(unit[m] in direction)) verdict = "changed"
+                else verdict = ((b > a) == (direction[unit[m]] > 0)) ? "B better" : "B worse"
+            }
+            printf "%-60s %-8s %14.2f %14.2f %+8.1f%%  %s\n", m, unit[m], a, b, delta, verdict
+        }
+    }
+' "$AB_DIR"/a.*.tsv "$AB_DIR"/b.*.tsv
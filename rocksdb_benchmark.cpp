@@ -15,27 +15,62 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <map>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
-#include <sys/time.h>
+#include <cmath>
+#include <time.h>
 #include <fstream>
 #include <sstream>
 #include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <sys/utsname.h>
+#include <filesystem>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <climits>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include <dlfcn.h>
+#include <malloc.h>
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/statistics.h"
 #include "rocksdb/table.h"
 #include "rocksdb/filter_policy.h"
+#include "rocksdb/slice_transform.h"
+#include "rocksdb/env.h"
+#include "rocksdb/file_system.h"
+#include "rocksdb/listener.h"
+#include "rocksdb/sst_file_writer.h"
+#include "rocksdb/utilities/checkpoint.h"
+#include "rocksdb/version.h"
+#include "rocksdb/convenience.h"
+#include "rocksdb/thread_status.h"
 
 #define DB_FILE      "benchmark_rocksdb"
+#define KEY_WIDTH_FILE "BENCHMARK_KEY_WIDTH"
 #define NUM_RECORDS  1000000
 #define BATCH_SIZE   1000
 #define NUM_READS    50000
 #define NUM_UPDATES  10000
 #define NUM_DELETES  5000
+#define NUM_MIXED_OPS 20000
+
+/* Set by make static (see Makefile); a plain build links the system library */
+#ifndef BENCH_ROCKSDB_BUILD
+#define BENCH_ROCKSDB_BUILD "system librocksdb"
+#endif
+#ifndef BENCH_CXXFLAGS
+#define BENCH_CXXFLAGS "unknown (built outside the Makefile)"
+#endif
 
 #define COLOR_BLUE   "\x1b[34m"
 #define COLOR_GREEN  "\x1b[32m"
@@ -45,11 +80,793 @@
 
 using namespace rocksdb;
 
-/* High-resolution timer */
+/* ==================== Command-line Flags ==================== */
+/*
+** All flags use the form --name=value. Defaults reproduce the
+** original fixed benchmark run.
+*/
+struct BenchFlags {
+    /* Steady-state detection before the second random-read pass:
+    **   none     - measure only right after the load ("fresh")
+    **   quiesce  - wait until no flush/compaction is pending or running
+    **   variance - run read windows until throughput CV drops below
+    **              steady_cv_pct over the last steady_windows windows */
+    std::string steady_state = "none";
+    int    steady_window_ops = 5000;
+    int    steady_windows = 5;
+    double steady_cv_pct = 5.0;
+    double steady_timeout_sec = 600.0;
+
+    /* Database location and size. With use_existing_db the directory
+    ** is neither destroyed nor loaded; num must describe its contents
+    ** (keys key_00000000 .. key_<num-1>). Unless a checkpoint is restored
+    ** first, the write phases are skipped so the dataset stays as loaded;
+    ** reuse_writes runs them anyway and changes it for good. */
+    std::string db = DB_FILE;
+    long long num = NUM_RECORDS;
+    bool use_existing_db = false;
+    bool reuse_writes = false;
+
+    /* Zero-pad width of every generated key index, derived from num in
+    ** parse_flags: at least 8, wide enough for 2*num (exists checks probe
+    ** past the end) so keys stay fixed-length and sort numerically. A
+    ** loaded DB records it (KEY_WIDTH_FILE) and reuse adopts that width;
+    ** set explicitly (re-executed replica primary), it must still fit. */
+    int key_width = 0;
+
+    /* Checkpoints let a loaded DB be reused across runs: save one after
+    ** the load, then restore it (hard-linked where possible) before
+    ** opening so every run starts from the same state. */
+    std::string save_checkpoint;
+    std::string restore_checkpoint;
+
+    /* Initial population:
+    **   serial  - BENCHMARK 1 as-is (single thread, synced batches)
+    **   wal_off - load_threads write disjoint sorted ranges with the WAL
+    **             disabled, then one final flush
+    **   ingest  - load_threads build SST files for their ranges with
+    **             SstFileWriter, then the files are ingested at once */
+    std::string loader = "serial";
+    int load_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+    int ingest_file_mb = 64;
+
+    /* Key order of the serial load (same batch size and sync setting):
+    **   sequential - ascending keys, RocksDB's best case
+    **   random     - every key once, in pseudo-random order
+    **   partial    - ascending runs of fill_run_length keys, with the
+    **                runs themselves written in random order */
+    std::string fill_order = "sequential";
+    long long fill_run_length = 10000;
+
+    /* Sustained overwrite benchmark (skipped when overwrite_ops is 0).
+    ** Updates keys drawn uniformly from a working set of
+    ** overwrite_working_set * num keys scattered across the key space. */
+    long long overwrite_ops = 0;
+    double overwrite_working_set = 1.0;
+    int overwrite_batch = BATCH_SIZE;
+    bool overwrite_sync = true;
+    int overwrite_report_sec = 10;
+
+    /* Every random choice derives from seed (0 = time-based), so a run
+    ** can be reproduced and its final state rebuilt for verification. */
+    uint64_t seed = 0;
+    bool verify = false;
+
+    /* Track expected state live while the benchmarks run (shadow_model)
+    ** and check every Get result against it (verify_reads). */
+    bool shadow_model = false;
+    bool verify_reads = false;
+    int verify_threads = (int)std::max(1u, std::thread::hardware_concurrency());
+
+    /* Async MultiGet benchmark (after the main run, on the same DB
+    ** reopened with direct reads): async_threads threads issuing
+    ** MultiGet batches with async_io versus sync_threads threads doing
+    ** one blocking Get each. */
+    bool async_bench = false;
+    int async_threads = 2;
+    int multiget_batch = 32;
+    int sync_threads = 32;
+    long long async_ops = 200000;
+    bool direct_reads = true;
+
+    /* Tenant-prefixed workload: keys t<tenant>_key_<n> spread over
+    ** prefix_tenants tenants, compared across BlockBasedTable (binary
+    ** and hash index) and PlainTable. prefix_in_memory sizes the cache
+    ** to hold everything and warms it before measuring. */
+    bool prefix_bench = false;
+    int prefix_tenants = 1000;
+    bool prefix_in_memory = false;
+
+    /* Read-only lookup tables: build the loaded dataset as BlockBased,
+    ** PlainTable and CuckooTable DBs and probe each opened read-only */
+    bool cuckoo_bench = false;
+
+    /* Replica benchmark: a primary process (this binary re-executed
+    ** with replica_primary=1) overwrites keys for replica_duration_sec
+    ** while this process measures OpenForReadOnly and a secondary
+    ** instance catching up every replica_catchup_ms. */
+    bool replica_bench = false;
+    bool replica_primary = false;
+    int replica_duration_sec = 30;
+    int replica_catchup_ms = 100;
+
+    /* Block format sweep: every combination of the lists below gets its
+    ** own scratch DB (2 MB cache, index kept out of the cache so table
+    ** reader memory shows its size) */
+    bool block_sweep = false;
+    std::vector<int> sweep_block_sizes = {1024, 4096, 16384, 65536};
+    std::vector<int> sweep_restart_intervals = {16};
+    std::vector<int> sweep_index_restart_intervals = {1};
+    std::vector<std::string> sweep_data_index = {"binary", "hash"};
+
+    /* Tiered placement: db_paths = {fast_path up to fast_target_mb,
+    ** slow_path unbounded}. slow_read_latency_us > 0 wraps the slow tier
+    ** in a FileSystem that delays every read, emulating cheaper disks. */
+    bool tiered_bench = false;
+    std::string fast_path;
+    std::string slow_path;
+    int fast_target_mb = 8;
+    int slow_read_latency_us = 0;
+    bool cold_last_level = false;
+    int tiered_rounds = 4;
+
+    /* Periodic/TTL compaction storms: load a scratch DB in one go (so
+    ** every file shares a creation time), then run a light read/write
+    ** foreground load for periodic_duration_sec with test-scaled
+    ** periodic_compaction_seconds and ttl. */
+    bool periodic_bench = false;
+    int periodic_compaction_sec = 60;
+    int ttl_sec = 120;
+    int periodic_duration_sec = 300;
+    int periodic_report_sec = 5;
+
+    /* Manual compaction value: full CompactRange after a random-order
+    ** load and again after overwrites, with read latency before/after;
+    ** compact_exclusive "both" runs it once per exclusive_manual_compaction */
+    bool compact_bench = false;
+    std::string compact_exclusive = "both";
+    std::string compact_bottommost = "if_filter";
+
+    /* WriteBatch sweep: the fill workload at each batch size, once with
+    ** a fresh WriteBatch per commit and once reusing a reserved one */
+    bool batch_sweep = false;
+    std::vector<int> sweep_batch_sizes = {1, 10, 100, 1000, 10000, 100000};
+    /* Fill and bulk insert reuse one reserved WriteBatch instead of a
+    ** fresh one per commit; off by default to keep results comparable */
+    bool reuse_batch = false;
+
+    /* Per-op latency clock: "clock" is clock_gettime(CLOCK_MONOTONIC),
+    ** "tsc" reads the (invariant) TSC calibrated against it */
+    std::string timer = "clock";
+
+    /* Random read key distribution; zipf ranks are scattered over the
+    ** key space so the hot set is not one contiguous block */
+    std::string read_dist = "uniform";
+    double zipf_theta = 0.99;
+
+    /* Machine-readable results: one "section / label<TAB>unit<TAB>value"
+    ** line per reported number, "#key<TAB>value" for run metadata */
+    std::string report;
+
+    /* DB properties after each main-suite phase:
+    **   none     - off
+    **   summary  - LSM shape, sizes, memtables and compaction totals
+    **   full     - also rocksdb.stats, rocksdb.levelstats and the
+    **              whole rocksdb.cfstats map */
+    std::string phase_properties = "summary";
+
+    /* Sample background thread activity (GetThreadList, with
+    ** enable_thread_tracking) every thread_status_ms during the main
+    ** suite and report per-pool utilization with each phase */
+    bool thread_status = false;
+    int thread_status_ms = 10;
+
+    /* Run only the harness primitive microbenchmarks (make microbench) */
+    bool harness_micro = false;
+};
+
+static BenchFlags FLAGS;
+
+static void print_usage(const char *prog) {
+    printf("Usage: %s [--flag=value ...]\n\n", prog);
+    printf("  --steady_state=none|quiesce|variance  (default: none)\n");
+    printf("  --steady_window_ops=N       reads per variance window (default: 5000)\n");
+    printf("  --steady_windows=N          sliding window length (default: 5)\n");
+    printf("  --steady_cv_pct=X           target throughput CV in %% (default: 5.0)\n");
+    printf("  --steady_timeout_sec=X      give up waiting after X seconds (default: 600)\n");
+    printf("  --db=PATH                   database directory (default: %s)\n", DB_FILE);
+    printf("  --num=N                     number of records (default: %d)\n", NUM_RECORDS);
+    printf("  --use_existing_db=0|1       reuse --db as-is, skip load and cleanup\n");
+    printf("  --reuse_writes=0|1          also run write phases on a reused DB (modifies it)\n");
+    printf("  --key_width=N               key index digits (default: from --num, or the reused DB's)\n");
+    printf("  --save_checkpoint=DIR       save a checkpoint of the DB after loading\n");
+    printf("  --restore_checkpoint=DIR    replace --db with DIR before opening\n");
+    printf("  --loader=serial|wal_off|ingest  initial population method (default: serial)\n");
+    printf("  --load_threads=N            parallel loader threads (default: all cores)\n");
+    printf("  --ingest_file_mb=N          SST size for --loader=ingest (default: 64)\n");
+    printf("  --fill_order=sequential|random|partial  serial load key order\n");
+    printf("  --fill_run_length=N         sorted run length for partial (default: 10000)\n");
+    printf("  --overwrite_ops=N           sustained overwrite benchmark ops (default: 0, off)\n");
+    printf("  --overwrite_working_set=F   fraction of keys overwritten (default: 1.0)\n");
+    printf("  --overwrite_batch=N         updates per WriteBatch (default: %d)\n", BATCH_SIZE);
+    printf("  --overwrite_sync=0|1        fsync each overwrite batch (default: 1)\n");
+    printf("  --overwrite_report_sec=N    interval report period (default: 10)\n");
+    printf("  --seed=N                    PRNG seed (default: 0, time-based)\n");
+    printf("  --verify=0|1                verify every key/value after the run\n");
+    printf("  --verify_threads=N          verification threads (default: all cores)\n");
+    printf("  --shadow_model=0|1          track expected state during the run\n");
+    printf("  --verify_reads=0|1          check every Get against the shadow model\n");
+    printf("  --async_bench=0|1           async MultiGet vs thread-per-request benchmark\n");
+    printf("  --async_threads=N           MultiGet threads (default: 2)\n");
+    printf("  --multiget_batch=N          keys per MultiGet (default: 32)\n");
+    printf("  --sync_threads=N            blocking Get threads (default: 32)\n");
+    printf("  --async_ops=N               lookups per model (default: 200000)\n");
+    printf("  --direct_reads=0|1          O_DIRECT reads for the async benchmark (default: 1)\n");
+    printf("  --prefix_bench=0|1          tenant-prefix Get/Seek across table formats\n");
+    printf("  --prefix_tenants=N          number of tenant prefixes (default: 1000)\n");
+    printf("  --prefix_in_memory=0|1      fully memory-resident prefix benchmark\n");
+    printf("  --cuckoo_bench=0|1          read-only CuckooTable vs BlockBased vs PlainTable\n");
+    printf("  --replica_bench=0|1         read-only and secondary instances vs live primary\n");
+    printf("  --replica_duration_sec=N    primary write duration (default: 30)\n");
+    printf("  --replica_catchup_ms=N      secondary catch-up interval (default: 100)\n");
+    printf("  --block_sweep=0|1           sweep block size / restart / data block index\n");
+    printf("  --sweep_block_sizes=A,B,..  block sizes in bytes (default: 1024,4096,16384,65536)\n");
+    printf("  --sweep_restart_intervals=A,B,..        block_restart_interval (default: 16)\n");
+    printf("  --sweep_index_restart_intervals=A,B,..  index_block_restart_interval (default: 1)\n");
+    printf("  --sweep_data_index=binary,hash          data_block_index_type (default: both)\n");
+    printf("  --tiered_bench=0|1          multi-path (fast/slow tier) placement benchmark\n");
+    printf("  --fast_path=DIR             fast tier (default: <db>_fast)\n");
+    printf("  --slow_path=DIR             slow tier (default: <db>_slow)\n");
+    printf("  --fast_target_mb=N          fast tier target size (default: 8)\n");
+    printf("  --slow_read_latency_us=N    added latency per slow-tier read (default: 0)\n");
+    printf("  --cold_last_level=0|1       set last_level_temperature=kCold\n");
+    printf("  --tiered_rounds=N           overwrite rounds to age the data (default: 4)\n");
+    printf("  --periodic_bench=0|1        periodic/TTL compaction impact benchmark\n");
+    printf("  --periodic_compaction_sec=N periodic_compaction_seconds (default: 60)\n");
+    printf("  --ttl_sec=N                 ttl (default: 120)\n");
+    printf("  --periodic_duration_sec=N   foreground run length (default: 300)\n");
+    printf("  --periodic_report_sec=N     report interval (default: 5)\n");
+    printf("  --compact_bench=0|1         manual CompactRange cost and read benefit\n");
+    printf("  --compact_exclusive=0|1|both  exclusive_manual_compaction (default: both)\n");
+    printf("  --compact_bottommost=skip|if_filter|force|force_optimized  (default: if_filter)\n");
+    printf("  --read_dist=uniform|zipf    random read key distribution (default: uniform)\n");
+    printf("  --zipf_theta=F              zipf skew, 0 < F < 1 (default: 0.99)\n");
+    printf("  --phase_properties=none|summary|full  DB properties after each phase (default: summary)\n");
+    printf("  --thread_status=0|1         background thread utilization per phase\n");
+    printf("  --thread_status_ms=N        sampling interval (default: 10)\n");
+    printf("  --report=FILE               also write results as TSV (see ab_compare.sh)\n");
+    printf("  --timer=clock|tsc           per-op latency clock (default: clock)\n");
+    printf("  --harness_micro=0|1         only measure harness primitive costs\n");
+    printf("  --batch_sweep=0|1           WriteBatch size sweep, fresh vs reused batch\n");
+    printf("  --sweep_batch_sizes=A,B,..  entries per batch (default: 1,10,100,1000,10000,100000)\n");
+    printf("  --reuse_batch=0|1           fill and bulk insert reuse a reserved WriteBatch\n");
+}
+
+/* Comma-separated list of positive integers */
+static bool parse_int_list(const char *v, std::vector<int> *out) {
+    out->clear();
+    for (const char *p = v; *p; ) {
+        char *end;
+        long n = strtol(p, &end, 10);
+        if (end == p || n <= 0) return false;
+        out->push_back((int)n);
+        p = *end == ',' ? end + 1 : end;
+        if (*end != ',' && *end != '\0') return false;
+    }
+    return !out->empty();
+}
+
+static std::vector<std::string> split_list(const char *v) {
+    std::vector<std::string> out;
+    std::stringstream ss(v);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) out.push_back(item);
+    }
+    return out;
+}
+
+/* Match "--name=value"; on success store a pointer to value */
+static bool flag_value(const char *arg, const char *name, const char **value) {
+    size_t len = strlen(name);
+    if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, len) != 0 ||
+        arg[2 + len] != '=') {
+        return false;
+    }
+    *value = arg + 3 + len;
+    return true;
+}
+
+static bool parse_flags(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *v;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            print_usage(argv[0]);
+            exit(0);
+        } else if (flag_value(arg, "steady_state", &v)) {
+            FLAGS.steady_state = v;
+        } else if (flag_value(arg, "steady_window_ops", &v)) {
+            FLAGS.steady_window_ops = atoi(v);
+        } else if (flag_value(arg, "steady_windows", &v)) {
+            FLAGS.steady_windows = atoi(v);
+        } else if (flag_value(arg, "steady_cv_pct", &v)) {
+            FLAGS.steady_cv_pct = atof(v);
+        } else if (flag_value(arg, "steady_timeout_sec", &v)) {
+            FLAGS.steady_timeout_sec = atof(v);
+        } else if (flag_value(arg, "db", &v)) {
+            FLAGS.db = v;
+        } else if (flag_value(arg, "num", &v)) {
+            FLAGS.num = atoll(v);
+        } else if (flag_value(arg, "use_existing_db", &v)) {
+            FLAGS.use_existing_db = atoi(v) != 0;
+        } else if (flag_value(arg, "reuse_writes", &v)) {
+            FLAGS.reuse_writes = atoi(v) != 0;
+        } else if (flag_value(arg, "key_width", &v)) {
+            FLAGS.key_width = atoi(v);
+        } else if (flag_value(arg, "save_checkpoint", &v)) {
+            FLAGS.save_checkpoint = v;
+        } else if (flag_value(arg, "restore_checkpoint", &v)) {
+            FLAGS.restore_checkpoint = v;
+        } else if (flag_value(arg, "loader", &v)) {
+            FLAGS.loader = v;
+        } else if (flag_value(arg, "load_threads", &v)) {
+            FLAGS.load_threads = atoi(v);
+        } else if (flag_value(arg, "ingest_file_mb", &v)) {
+            FLAGS.ingest_file_mb = atoi(v);
+        } else if (flag_value(arg, "fill_order", &v)) {
+            FLAGS.fill_order = v;
+        } else if (flag_value(arg, "fill_run_length", &v)) {
+            FLAGS.fill_run_length = atoll(v);
+        } else if (flag_value(arg, "overwrite_ops", &v)) {
+            FLAGS.overwrite_ops = atoll(v);
+        } else if (flag_value(arg, "overwrite_working_set", &v)) {
+            FLAGS.overwrite_working_set = atof(v);
+        } else if (flag_value(arg, "overwrite_batch", &v)) {
+            FLAGS.overwrite_batch = atoi(v);
+        } else if (flag_value(arg, "overwrite_sync", &v)) {
+            FLAGS.overwrite_sync = atoi(v) != 0;
+        } else if (flag_value(arg, "overwrite_report_sec", &v)) {
+            FLAGS.overwrite_report_sec = atoi(v);
+        } else if (flag_value(arg, "seed", &v)) {
+            FLAGS.seed = strtoull(v, NULL, 10);
+        } else if (flag_value(arg, "verify", &v)) {
+            FLAGS.verify = atoi(v) != 0;
+        } else if (flag_value(arg, "verify_threads", &v)) {
+            FLAGS.verify_threads = atoi(v);
+        } else if (flag_value(arg, "shadow_model", &v)) {
+            FLAGS.shadow_model = atoi(v) != 0;
+        } else if (flag_value(arg, "verify_reads", &v)) {
+            FLAGS.verify_reads = atoi(v) != 0;
+        } else if (flag_value(arg, "async_bench", &v)) {
+            FLAGS.async_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "async_threads", &v)) {
+            FLAGS.async_threads = atoi(v);
+        } else if (flag_value(arg, "multiget_batch", &v)) {
+            FLAGS.multiget_batch = atoi(v);
+        } else if (flag_value(arg, "sync_threads", &v)) {
+            FLAGS.sync_threads = atoi(v);
+        } else if (flag_value(arg, "async_ops", &v)) {
+            FLAGS.async_ops = atoll(v);
+        } else if (flag_value(arg, "direct_reads", &v)) {
+            FLAGS.direct_reads = atoi(v) != 0;
+        } else if (flag_value(arg, "prefix_bench", &v)) {
+            FLAGS.prefix_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "prefix_tenants", &v)) {
+            FLAGS.prefix_tenants = atoi(v);
+        } else if (flag_value(arg, "prefix_in_memory", &v)) {
+            FLAGS.prefix_in_memory = atoi(v) != 0;
+        } else if (flag_value(arg, "cuckoo_bench", &v)) {
+            FLAGS.cuckoo_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "replica_bench", &v)) {
+            FLAGS.replica_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "replica_primary", &v)) {
+            FLAGS.replica_primary = atoi(v) != 0;
+        } else if (flag_value(arg, "replica_duration_sec", &v)) {
+            FLAGS.replica_duration_sec = atoi(v);
+        } else if (flag_value(arg, "replica_catchup_ms", &v)) {
+            FLAGS.replica_catchup_ms = atoi(v);
+        } else if (flag_value(arg, "block_sweep", &v)) {
+            FLAGS.block_sweep = atoi(v) != 0;
+        } else if (flag_value(arg, "sweep_block_sizes", &v)) {
+            if (!parse_int_list(v, &FLAGS.sweep_block_sizes)) {
+                fprintf(stderr, "Invalid --sweep_block_sizes: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "sweep_restart_intervals", &v)) {
+            if (!parse_int_list(v, &FLAGS.sweep_restart_intervals)) {
+                fprintf(stderr, "Invalid --sweep_restart_intervals: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "sweep_index_restart_intervals", &v)) {
+            if (!parse_int_list(v, &FLAGS.sweep_index_restart_intervals)) {
+                fprintf(stderr, "Invalid --sweep_index_restart_intervals: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "sweep_data_index", &v)) {
+            FLAGS.sweep_data_index = split_list(v);
+            for (const auto &t : FLAGS.sweep_data_index) {
+                if (t != "binary" && t != "hash") {
+                    fprintf(stderr, "Invalid --sweep_data_index: %s\n", t.c_str());
+                    return false;
+                }
+            }
+        } else if (flag_value(arg, "tiered_bench", &v)) {
+            FLAGS.tiered_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "fast_path", &v)) {
+            FLAGS.fast_path = v;
+        } else if (flag_value(arg, "slow_path", &v)) {
+            FLAGS.slow_path = v;
+        } else if (flag_value(arg, "fast_target_mb", &v)) {
+            FLAGS.fast_target_mb = atoi(v);
+        } else if (flag_value(arg, "slow_read_latency_us", &v)) {
+            FLAGS.slow_read_latency_us = atoi(v);
+        } else if (flag_value(arg, "cold_last_level", &v)) {
+            FLAGS.cold_last_level = atoi(v) != 0;
+        } else if (flag_value(arg, "tiered_rounds", &v)) {
+            FLAGS.tiered_rounds = atoi(v);
+        } else if (flag_value(arg, "periodic_bench", &v)) {
+            FLAGS.periodic_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "periodic_compaction_sec", &v)) {
+            FLAGS.periodic_compaction_sec = atoi(v);
+        } else if (flag_value(arg, "ttl_sec", &v)) {
+            FLAGS.ttl_sec = atoi(v);
+        } else if (flag_value(arg, "periodic_duration_sec", &v)) {
+            FLAGS.periodic_duration_sec = atoi(v);
+        } else if (flag_value(arg, "periodic_report_sec", &v)) {
+            FLAGS.periodic_report_sec = atoi(v);
+        } else if (flag_value(arg, "compact_bench", &v)) {
+            FLAGS.compact_bench = atoi(v) != 0;
+        } else if (flag_value(arg, "compact_exclusive", &v)) {
+            FLAGS.compact_exclusive = v;
+        } else if (flag_value(arg, "compact_bottommost", &v)) {
+            FLAGS.compact_bottommost = v;
+        } else if (flag_value(arg, "read_dist", &v)) {
+            FLAGS.read_dist = v;
+            if (FLAGS.read_dist != "uniform" && FLAGS.read_dist != "zipf") {
+                fprintf(stderr, "Invalid --read_dist: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "zipf_theta", &v)) {
+            FLAGS.zipf_theta = atof(v);
+            if (FLAGS.zipf_theta <= 0 || FLAGS.zipf_theta >= 1) {
+                fprintf(stderr, "Invalid --zipf_theta: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "phase_properties", &v)) {
+            FLAGS.phase_properties = v;
+            if (FLAGS.phase_properties != "none" && FLAGS.phase_properties != "summary" &&
+                FLAGS.phase_properties != "full") {
+                fprintf(stderr, "Invalid --phase_properties: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "thread_status", &v)) {
+            FLAGS.thread_status = atoi(v) != 0;
+        } else if (flag_value(arg, "thread_status_ms", &v)) {
+            FLAGS.thread_status_ms = atoi(v);
+            if (FLAGS.thread_status_ms <= 0) {
+                fprintf(stderr, "Invalid --thread_status_ms: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "report", &v)) {
+            FLAGS.report = v;
+        } else if (flag_value(arg, "timer", &v)) {
+            FLAGS.timer = v;
+            if (FLAGS.timer != "clock" && FLAGS.timer != "tsc") {
+                fprintf(stderr, "Invalid --timer: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "harness_micro", &v)) {
+            FLAGS.harness_micro = atoi(v) != 0;
+        } else if (flag_value(arg, "batch_sweep", &v)) {
+            FLAGS.batch_sweep = atoi(v) != 0;
+        } else if (flag_value(arg, "sweep_batch_sizes", &v)) {
+            if (!parse_int_list(v, &FLAGS.sweep_batch_sizes)) {
+                fprintf(stderr, "Invalid --sweep_batch_sizes: %s\n", v);
+                return false;
+            }
+        } else if (flag_value(arg, "reuse_batch", &v)) {
+            FLAGS.reuse_batch = atoi(v) != 0;
+        } else {
+            fprintf(stderr, "Unknown flag: %s\n\n", arg);
+            print_usage(argv[0]);
+            return false;
+        }
+    }
+
+    if (FLAGS.steady_state != "none" && FLAGS.steady_state != "quiesce" &&
+        FLAGS.steady_state != "variance") {
+        fprintf(stderr, "Invalid --steady_state: %s\n", FLAGS.steady_state.c_str());
+        return false;
+    }
+    if (FLAGS.steady_window_ops <= 0 || FLAGS.steady_windows < 2) {
+        fprintf(stderr, "--steady_window_ops must be > 0 and --steady_windows >= 2\n");
+        return false;
+    }
+    if (FLAGS.num <= 0) {
+        fprintf(stderr, "--num must be > 0\n");
+        return false;
+    }
+    if (FLAGS.loader != "serial" && FLAGS.loader != "wal_off" &&
+        FLAGS.loader != "ingest") {
+        fprintf(stderr, "Invalid --loader: %s\n", FLAGS.loader.c_str());
+        return false;
+    }
+    if (FLAGS.load_threads <= 0 || FLAGS.ingest_file_mb <= 0) {
+        fprintf(stderr, "--load_threads and --ingest_file_mb must be > 0\n");
+        return false;
+    }
+    if (FLAGS.fill_order != "sequential" && FLAGS.fill_order != "random" &&
+        FLAGS.fill_order != "partial") {
+        fprintf(stderr, "Invalid --fill_order: %s\n", FLAGS.fill_order.c_str());
+        return false;
+    }
+    if (FLAGS.fill_order != "sequential" && FLAGS.loader != "serial") {
+        fprintf(stderr, "--fill_order applies to --loader=serial only\n");
+        return false;
+    }
+    if (FLAGS.fill_run_length <= 0) {
+        fprintf(stderr, "--fill_run_length must be > 0\n");
+        return false;
+    }
+    if (FLAGS.overwrite_working_set <= 0 || FLAGS.overwrite_working_set > 1 ||
+        FLAGS.overwrite_batch <= 0 || FLAGS.overwrite_report_sec <= 0) {
+        fprintf(stderr, "--overwrite_working_set must be in (0, 1]; "
+                "--overwrite_batch and --overwrite_report_sec must be > 0\n");
+        return false;
+    }
+    if (FLAGS.overwrite_ops > (long long)UINT32_MAX - 4) {
+        // Overwrite versions are tracked in 32 bits by the verifier
+        fprintf(stderr, "--overwrite_ops must be <= %llu\n",
+                (unsigned long long)UINT32_MAX - 4);
+        return false;
+    }
+    if (FLAGS.verify_threads <= 0) {
+        fprintf(stderr, "--verify_threads must be > 0\n");
+        return false;
+    }
+    if (FLAGS.async_threads <= 0 || FLAGS.multiget_batch <= 0 ||
+        FLAGS.sync_threads <= 0 || FLAGS.async_ops <= 0) {
+        fprintf(stderr, "--async_threads, --multiget_batch, --sync_threads and "
+                "--async_ops must be > 0\n");
+        return false;
+    }
+    // Every lookup thread needs at least one op
+    if (FLAGS.async_ops < std::max(FLAGS.async_threads, FLAGS.sync_threads)) {
+        fprintf(stderr, "--async_ops must be >= --async_threads and --sync_threads (%d)\n",
+                std::max(FLAGS.async_threads, FLAGS.sync_threads));
+        return false;
+    }
+    if (FLAGS.prefix_tenants <= 0 || FLAGS.prefix_tenants > 99999) {
+        fprintf(stderr, "--prefix_tenants must be in [1, 99999]\n");
+        return false;
+    }
+    if (FLAGS.replica_duration_sec <= 0 || FLAGS.replica_catchup_ms <= 0) {
+        fprintf(stderr, "--replica_duration_sec and --replica_catchup_ms must be > 0\n");
+        return false;
+    }
+    if (FLAGS.fast_target_mb <= 0 || FLAGS.slow_read_latency_us < 0 ||
+        FLAGS.tiered_rounds < 0) {
+        fprintf(stderr, "--fast_target_mb must be > 0; --slow_read_latency_us and "
+                "--tiered_rounds must be >= 0\n");
+        return false;
+    }
+    if (FLAGS.periodic_compaction_sec < 0 || FLAGS.ttl_sec < 0 ||
+        FLAGS.periodic_duration_sec <= 0 || FLAGS.periodic_report_sec <= 0) {
+        fprintf(stderr, "Invalid periodic benchmark settings\n");
+        return false;
+    }
+    if (FLAGS.compact_exclusive != "0" && FLAGS.compact_exclusive != "1" &&
+        FLAGS.compact_exclusive != "both") {
+        fprintf(stderr, "Invalid --compact_exclusive: %s\n", FLAGS.compact_exclusive.c_str());
+        return false;
+    }
+    if (FLAGS.compact_bottommost != "skip" && FLAGS.compact_bottommost != "if_filter" &&
+        FLAGS.compact_bottommost != "force" && FLAGS.compact_bottommost != "force_optimized") {
+        fprintf(stderr, "Invalid --compact_bottommost: %s\n", FLAGS.compact_bottommost.c_str());
+        return false;
+    }
+    if (FLAGS.fast_path.empty()) FLAGS.fast_path = FLAGS.db + "_fast";
+    if (FLAGS.slow_path.empty()) FLAGS.slow_path = FLAGS.db + "_slow";
+    if (FLAGS.verify_reads) {
+        FLAGS.shadow_model = true;
+    }
+    if (FLAGS.seed == 0) {
+        FLAGS.seed = (uint64_t)time(NULL);
+    }
+    int width = 1;
+    for (long long limit = 2 * FLAGS.num - 1; limit >= 10; limit /= 10) width++;
+    width = std::max(8, width);
+    if (FLAGS.key_width == 0) {
+        FLAGS.key_width = width;
+    } else if (FLAGS.key_width < width || FLAGS.key_width > 18) {
+        fprintf(stderr, "--key_width must be %d..18 for --num=%lld\n", width, FLAGS.num);
+        return false;
+    }
+    if (!FLAGS.restore_checkpoint.empty() && !FLAGS.use_existing_db) {
+        fprintf(stderr, "--restore_checkpoint requires --use_existing_db=1\n");
+        return false;
+    }
+    // Both models assume a fresh load, which only a checkpoint guarantees
+    if (FLAGS.use_existing_db && FLAGS.restore_checkpoint.empty() &&
+        (FLAGS.verify || FLAGS.shadow_model)) {
+        fprintf(stderr, "--verify, --shadow_model and --verify_reads need "
+                "--restore_checkpoint with --use_existing_db=1\n");
+        return false;
+    }
+    return true;
+}
+
+/* ==================== Timers ==================== */
+/* Phase timing: monotonic seconds, immune to NTP steps */
 static double get_time(void) {
-    struct timeval tv;
-    gettimeofday(&tv, NULL);
-    return tv.tv_sec + tv.tv_usec / 1000000.0;
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* Per-op latency samples go through now_ns()/elapsed_ns(). With
+** --timer=tsc they read the TSC and scale by the calibrated tick length;
+** either way the median cost of a back-to-back timer pair is subtracted
+** from every sample, so sub-microsecond ops are not inflated by it. */
+static bool g_use_tsc = false;
+static double g_ns_per_tick = 1.0;
+static uint64_t g_timer_overhead_ns = 0;
+
+static inline uint64_t clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static inline uint64_t now_ns(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (g_use_tsc) {
+        unsigned int aux;
+        return (uint64_t)(__rdtscp(&aux) * g_ns_per_tick);
+    }
+#endif
+    return clock_ns();
+}
+
+static inline uint64_t elapsed_ns(uint64_t t0) {
+    uint64_t d = now_ns() - t0;
+    return d > g_timer_overhead_ns ? d - g_timer_overhead_ns : 0;
+}
+
+/* The TSC is only a clock if it ticks at a constant rate through
+** frequency changes and idle states */
+static bool tsc_is_invariant(void) {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 5, "flags") == 0) {
+            return line.find(" constant_tsc") != std::string::npos &&
+                   line.find(" nonstop_tsc") != std::string::npos;
+        }
+    }
+    return false;
+}
+
+static void init_timer(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    if (FLAGS.timer == "tsc") {
+        if (tsc_is_invariant()) {
+            // Calibrate over 50 ms of CLOCK_MONOTONIC
+            unsigned int aux;
+            uint64_t c0 = clock_ns(), t0 = __rdtscp(&aux);
+            while (clock_ns() - c0 < 50000000ULL) {}
+            uint64_t c1 = clock_ns(), t1 = __rdtscp(&aux);
+            g_ns_per_tick = (double)(c1 - c0) / (double)(t1 - t0);
+            g_use_tsc = true;
+        } else {
+            fprintf(stderr, "TSC is not invariant on this CPU; using clock_gettime\n");
+        }
+    }
+#else
+    if (FLAGS.timer == "tsc") {
+        fprintf(stderr, "--timer=tsc is x86-only; using clock_gettime\n");
+    }
+#endif
+
+    const int samples = 10001;
+    std::vector<uint64_t> pairs(samples);
+    for (int i = 0; i < samples; i++) {
+        uint64_t t0 = now_ns();
+        pairs[i] = now_ns() - t0;
+    }
+    std::nth_element(pairs.begin(), pairs.begin() + samples / 2, pairs.end());
+    g_timer_overhead_ns = pairs[samples / 2];
+}
+
+static void print_timer(void) {
+    if (g_use_tsc) {
+        printf("  Timer: TSC at %.3f GHz, %llu ns overhead subtracted per sample\n",
+               1.0 / g_ns_per_tick, (unsigned long long)g_timer_overhead_ns);
+    } else {
+        printf("  Timer: CLOCK_MONOTONIC, %llu ns overhead subtracted per sample\n",
+               (unsigned long long)g_timer_overhead_ns);
+    }
+}
+
+/* Deterministic PRNG (splitmix64). Each benchmark draws from its own
+** stream so the verifier can replay the mutating ones exactly. */
+struct BenchRandom {
+    uint64_t state;
+
+    explicit BenchRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    /* Uniform index in [0, n), wide enough for billions of keys */
+    long long uniform(long long n) { return (long long)(next() % (uint64_t)n); }
+};
+
+/* zeta(n, theta) = sum of 1/i^theta over [1, n]. The first
+** ZETA_EXACT_TERMS terms are summed directly and the rest by
+** Euler-Maclaurin (integral, endpoint and first-derivative terms),
+** which at that cutoff agrees with the direct sum to ~1e-13; summing
+** all n terms would cost n pow() calls, seconds at 1e9 keys. */
+#define ZETA_EXACT_TERMS 10000
+
+static double zeta(long long n, double theta) {
+    const long long exact = std::min(n, (long long)ZETA_EXACT_TERMS);
+    double sum = 0;
+    for (long long i = 1; i <= exact; i++) sum += 1.0 / pow((double)i, theta);
+    if (n == exact) return sum;
+
+    double a = (double)exact, b = (double)n;
+    return sum + (pow(b, 1.0 - theta) - pow(a, 1.0 - theta)) / (1.0 - theta) +
+           (pow(b, -theta) - pow(a, -theta)) / 2 +
+           theta * (pow(a, -theta - 1.0) - pow(b, -theta - 1.0)) / 12;
+}
+
+/* Zipfian rank in [0, n) with skew theta, rank 0 hottest (the YCSB
+** generator, after Gray et al.) */
+struct ZipfGenerator {
+    long long n;
+    double theta, alpha, zetan, eta, half_pow_theta;
+
+    ZipfGenerator(long long n_, double theta_) : n(n_), theta(theta_) {
+        zetan = zeta(n, theta);
+        double zeta2 = 1.0 + pow(0.5, theta);
+        half_pow_theta = pow(0.5, theta);
+        alpha = 1.0 / (1.0 - theta);
+        eta = (1.0 - pow(2.0 / n, 1.0 - theta)) / (1.0 - zeta2 / zetan);
+    }
+
+    long long next(BenchRandom &rng) const {
+        double u = (rng.next() >> 11) * (1.0 / 9007199254740992.0);
+        double uz = u * zetan;
+        if (uz < 1.0) return 0;
+        if (uz < 1.0 + half_pow_theta) return 1;
+        long long r = (long long)(n * pow(eta * u - eta + 1.0, alpha));
+        return r < n ? r : n - 1;
+    }
+};
+
+enum RandomStream {
+    STREAM_FILL = 1,
+    STREAM_READS,
+    STREAM_UPDATES,
+    STREAM_DELETES,
+    STREAM_EXISTS,
+    STREAM_MIXED,
+    STREAM_OVERWRITE,
+    /* Key permutations get streams of their own: seeded like the index
+    ** stream they scatter, the permutation would be correlated with it */
+    STREAM_READ_SCATTER,
+    STREAM_OVERWRITE_SCATTER,
+};
+
+static uint64_t stream_seed(RandomStream stream) {
+    return FLAGS.seed * 0x100000001B3ULL + (uint64_t)stream * 0x9E3779B97F4A7C15ULL;
 }
 
 /* Format numbers with commas */
@@ -92,17 +909,369 @@ static void format_memory(long kb, char *buf, size_t size) {
     }
 }
 
-static void print_result(const char *test, double elapsed, int ops) {
+/* ==================== Allocator ==================== */
+/* The allocator is whatever the variant was linked with (make allocators)
+** or LD_PRELOADed, so it is detected by its exported symbols.  Each one is
+** looked up with dlsym so the build never depends on a particular malloc. */
+struct HeapStats {
+    const char *allocator;
+    uint64_t allocated;    /* bytes handed out to the application */
+    uint64_t reserved;     /* bytes the allocator holds from the OS */
+};
+
+typedef int (*MallctlFn)(const char *, void *, size_t *, void *, size_t);
+typedef int (*TcPropertyFn)(const char *, size_t *);
+typedef void (*MiProcessInfoFn)(size_t *, size_t *, size_t *, size_t *, size_t *,
+                                size_t *, size_t *, size_t *);
+
+static size_t jemalloc_stat(MallctlFn mallctl, const char *name) {
+    size_t value = 0, size = sizeof(value);
+    mallctl(name, &value, &size, NULL, 0);
+    return value;
+}
+
+static HeapStats get_heap_stats() {
+    HeapStats h = {"glibc", 0, 0};
+
+    if (MallctlFn mallctl = (MallctlFn)dlsym(RTLD_DEFAULT, "mallctl")) {
+        // Stats are cached until the epoch is advanced
+        uint64_t epoch = 1;
+        size_t size = sizeof(epoch);
+        mallctl("epoch", &epoch, &size, &epoch, size);
+        h.allocator = "jemalloc";
+        h.allocated = jemalloc_stat(mallctl, "stats.allocated");
+        h.reserved = jemalloc_stat(mallctl, "stats.resident");
+    } else if (TcPropertyFn prop =
+                   (TcPropertyFn)dlsym(RTLD_DEFAULT, "MallocExtension_GetNumericProperty")) {
+        size_t allocated = 0, heap = 0, unmapped = 0;
+        prop("generic.current_allocated_bytes", &allocated);
+        prop("generic.heap_size", &heap);
+        prop("tcmalloc.pageheap_unmapped_bytes", &unmapped);
+        h.allocator = "tcmalloc";
+        h.allocated = allocated;
+        h.reserved = heap - unmapped;
+    } else if (MiProcessInfoFn info = (MiProcessInfoFn)dlsym(RTLD_DEFAULT, "mi_process_info")) {
+        // mimalloc only exposes committed memory, not live bytes
+        size_t elapsed, user, sys, rss, peak_rss, commit, peak_commit, faults;
+        info(&elapsed, &user, &sys, &rss, &peak_rss, &commit, &peak_commit, &faults);
+        h.allocator = "mimalloc";
+        h.reserved = commit;
+    } else {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+        struct mallinfo2 mi = mallinfo2();
+        h.allocated = mi.uordblks + mi.hblkhd;
+        h.reserved = mi.arena + mi.hblkhd;
+#endif
+    }
+    return h;
+}
+
+static void print_heap_stats(void) {
+    HeapStats h = get_heap_stats();
+    long rss = get_memory_usage();
+    char buf[32];
+
+    printf("\n");
+    printf("  Allocator (%s):\n", h.allocator);
+    if (h.allocated) {
+        format_memory((long)(h.allocated / 1024), buf, sizeof(buf));
+        printf("    - Allocated:       %s\n", buf);
+    }
+    if (h.reserved) {
+        format_memory((long)(h.reserved / 1024), buf, sizeof(buf));
+        printf("    - Heap reserved:   %s\n", buf);
+    }
+    format_memory(rss, buf, sizeof(buf));
+    printf("    - Process RSS:     %s\n", buf);
+    // Share of the allocator's heap (and of RSS) not backing live objects
+    if (h.allocated && h.reserved) {
+        printf("    - Fragmentation:   %.1f%% of heap, %.1f%% of RSS\n",
+               100.0 * ((double)h.reserved - h.allocated) / h.reserved,
+               rss > 0 ? 100.0 * ((double)rss * 1024 - h.allocated) / ((double)rss * 1024) : 0.0);
+    }
+}
+
+/* ==================== Result Report ==================== */
+/* Metrics are keyed by the current benchmark header, since labels like
+** "Read latency after" recur across benchmarks, plus a subsection where
+** one benchmark repeats its labels per format, instance or phase. Every
+** key must be unique within a run; ab_compare.sh rejects duplicates. */
+static FILE *g_report = NULL;
+static std::string g_report_section;
+static std::string g_report_subsection;
+
+/* Cleared by print_header */
+static void report_subsection(const std::string &name) {
+    g_report_subsection = name;
+}
+
+static void report_metric(const char *label, const char *unit, double value) {
+    if (!g_report) return;
+    fprintf(g_report, "%s / %s%s%s\t%s\t%.6g\n", g_report_section.c_str(),
+            g_report_subsection.c_str(), g_report_subsection.empty() ? "" : " / ",
+            label, unit, value);
+}
+
+static void report_meta(const char *key, const std::string &value) {
+    if (!g_report) return;
+    fprintf(g_report, "#%s\t%s\n", key, value.c_str());
+}
+
+/* ==================== Build Info ==================== */
+/* Headers and library are reported separately: a mismatch means the
+** binary was built against one RocksDB and runs against another */
+static void print_build_info(void) {
+    char headers[32];
+    snprintf(headers, sizeof(headers), "%d.%d.%d", ROCKSDB_MAJOR, ROCKSDB_MINOR, ROCKSDB_PATCH);
+    std::string library = GetRocksVersionAsString(true);
+
+    printf("  RocksDB: %s (headers %s)\n", library.c_str(), headers);
+    if (library != headers) {
+        printf("  " COLOR_YELLOW "Warning: library and header versions differ" COLOR_RESET "\n");
+    }
+    printf("  RocksDB build: %s\n", BENCH_ROCKSDB_BUILD);
+    report_meta("rocksdb", library);
+    report_meta("rocksdb_build", BENCH_ROCKSDB_BUILD);
+
+    const auto &props = GetRocksBuildProperties();
+    std::map<std::string, std::string> sorted(props.begin(), props.end());
+    for (const auto &p : sorted) {
+        printf("    %-26s %s\n", p.first.c_str(), p.second.c_str());
+    }
+}
+
+/* ==================== Environment Fingerprint ==================== */
+/* Enough context to tell whether two result sets are comparable */
+static std::string read_first_line(const char *path) {
+    std::ifstream in(path);
+    std::string line;
+    std::getline(in, line);
+    return line;
+}
+
+/* "always [madvise] never" -> "madvise" */
+static std::string bracketed_choice(const std::string &line) {
+    size_t open = line.find('['), close = line.find(']');
+    if (open == std::string::npos || close == std::string::npos) return line;
+    return line.substr(open + 1, close - open - 1);
+}
+
+static std::string cpu_model(void) {
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t colon = line.find(':');
+            return colon == std::string::npos ? line : line.substr(colon + 2);
+        }
+    }
+    return "unknown";
+}
+
+/* Filesystem type and mount options of the mount holding path, from
+** the longest matching mount point in /proc/self/mountinfo */
+static void mount_for_path(const std::string &path, std::string *fstype,
+                           std::string *options) {
+    std::error_code ec;
+    std::string abs = std::filesystem::weakly_canonical(std::filesystem::absolute(path), ec);
+    std::ifstream mountinfo("/proc/self/mountinfo");
+    std::string line;
+    size_t best = 0;
+
+    *fstype = "unknown";
+    while (std::getline(mountinfo, line)) {
+        // id parent dev root mountpoint options [optional...] - fstype source superoptions
+        std::istringstream in(line);
+        std::string id, parent, dev, root, mountpoint, mount_opts, field;
+        in >> id >> parent >> dev >> root >> mountpoint >> mount_opts;
+        while (in >> field && field != "-") {}
+        std::string type, source;
+        in >> type >> source;
+
+        bool under = abs.compare(0, mountpoint.size(), mountpoint) == 0 &&
+                     (mountpoint == "/" || abs.size() == mountpoint.size() ||
+                      abs[mountpoint.size()] == '/');
+        if (under && mountpoint.size() >= best) {
+            best = mountpoint.size();
+            *fstype = type;
+            *options = mount_opts;
+        }
+    }
+}
+
+static void print_environment(void) {
+    struct utsname un;
+    std::string kernel = uname(&un) == 0 ? std::string(un.release) + " " + un.machine : "unknown";
+    std::string governor =
+        read_first_line("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+    std::string thp = bracketed_choice(
+        read_first_line("/sys/kernel/mm/transparent_hugepage/enabled"));
+    std::string fstype, mount_opts;
+    mount_for_path(FLAGS.db, &fstype, &mount_opts);
+    std::string cores = std::to_string(std::thread::hardware_concurrency());
+
+    printf("  CPU: %s, %s cores, governor %s\n", cpu_model().c_str(), cores.c_str(),
+           governor.empty() ? "n/a" : governor.c_str());
+    printf("  Kernel: %s, THP %s\n", kernel.c_str(), thp.empty() ? "n/a" : thp.c_str());
+    printf("  DB filesystem: %s (%s)\n", fstype.c_str(), mount_opts.c_str());
+    printf("  Compiler: %s, %s\n", __VERSION__, BENCH_CXXFLAGS);
+
+    if (!governor.empty() && governor != "performance") {
+        printf("  " COLOR_YELLOW "Warning: CPU governor is %s, not performance; "
+               "results will vary with frequency scaling" COLOR_RESET "\n", governor.c_str());
+    }
+    if (fstype == "tmpfs" || fstype == "ramfs") {
+        printf("  " COLOR_YELLOW "Warning: %s is on %s; I/O and fsync cost is not measured"
+               COLOR_RESET "\n", FLAGS.db.c_str(), fstype.c_str());
+    }
+
+    report_meta("cpu", cpu_model());
+    report_meta("cores", cores);
+    report_meta("governor", governor);
+    report_meta("kernel", kernel);
+    report_meta("thp", thp);
+    report_meta("db_fs", fstype + " (" + mount_opts + ")");
+    report_meta("compiler", std::string(__VERSION__) + ", " + BENCH_CXXFLAGS);
+}
+
+/* Every DB and column family option the main DB was opened with, one
+** per line, so a run can be reproduced exactly */
+static void print_full_options(const Options &options) {
+    std::string db_opts, cf_opts;
+    GetStringFromDBOptions(&db_opts, options, "\n");
+    GetStringFromColumnFamilyOptions(&cf_opts, options, "\n");
+
+    printf("\n  Full options:\n");
+    std::istringstream in(db_opts + "\n" + cf_opts);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        printf("    %s\n", line.c_str());
+        size_t eq = line.find('=');
+        if (eq != std::string::npos) {
+            report_meta(("option." + line.substr(0, eq)).c_str(), line.substr(eq + 1));
+        }
+    }
+}
+
+static void print_result(const char *test, double elapsed, long long ops) {
     double ops_per_sec = ops / elapsed;
     char buf[32];
     format_number((long long)ops_per_sec, buf, sizeof(buf));
 
     printf("  %-30s: ", test);
     printf(COLOR_GREEN "%s ops/sec" COLOR_RESET " ", buf);
-    printf("(%.3f seconds for %d ops)\n", elapsed, ops);
+    printf("(%.3f seconds for %lld ops)\n", elapsed, ops);
+    report_metric(test, "ops/sec", ops_per_sec);
+}
+
+/* ==================== Status Checking ==================== */
+/* Failed Write/Get calls per benchmark, listed again in the summary so
+** that a fast but broken run cannot pass unnoticed. NotFound from Get
+** is an expected outcome, not a failure. */
+static std::vector<std::pair<std::string, long long>> g_status_errors;
+
+static bool read_failed(const Status &s) {
+    return !s.ok() && !s.IsNotFound();
+}
+
+static void record_errors(const char *test, long long errors) {
+    g_status_errors.emplace_back(test, errors);
+    if (errors > 0) {
+        printf("  %-30s: " COLOR_YELLOW "%lld failed calls" COLOR_RESET "\n",
+               "Status errors", errors);
+    }
+}
+
+static void print_status_errors(void) {
+    long long total = 0;
+    for (const auto &e : g_status_errors) total += e.second;
+
+    printf("\n");
+    if (total == 0) {
+        printf("  Status errors: none\n");
+        return;
+    }
+    printf("  Status errors:\n");
+    for (const auto &e : g_status_errors) {
+        if (e.second > 0) {
+            printf("    - %-28s " COLOR_YELLOW "%lld" COLOR_RESET "\n",
+                   e.first.c_str(), e.second);
+        }
+    }
+}
+
+/* ==================== Latency Histogram ==================== */
+/* Log-linear histogram of nanosecond latencies: values below 16 get
+** their own bucket, larger ones 16 sub-buckets per power of two (about
+** 6% resolution). One per thread, merged after the run. */
+struct LatencyHistogram {
+    static const int kBuckets = 60 * 16 + 16;
+    uint64_t counts[kBuckets] = {};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    static int bucket(uint64_t ns) {
+        if (ns < 16) return (int)ns;
+        int e = 63 - __builtin_clzll(ns);
+        return (e - 3) * 16 + (int)((ns >> (e - 4)) & 15);
+    }
+
+    /* Upper bound of a bucket, reported for percentiles */
+    static uint64_t bucket_limit(int b) {
+        if (b < 16) return b;
+        int e = b / 16 + 3;
+        return ((16ULL + b % 16 + 1) << (e - 4)) - 1;
+    }
+
+    void add(uint64_t ns) {
+        counts[bucket(ns)]++;
+        total++;
+        sum += ns;
+        if (ns > max) max = ns;
+    }
+
+    void merge(const LatencyHistogram &other) {
+        for (int b = 0; b < kBuckets; b++) counts[b] += other.counts[b];
+        total += other.total;
+        sum += other.sum;
+        if (other.max > max) max = other.max;
+    }
+
+    uint64_t percentile(double p) const {
+        uint64_t target = (uint64_t)(total * p / 100.0), seen = 0;
+        for (int b = 0; b < kBuckets; b++) {
+            seen += counts[b];
+            if (seen > target) return std::min(bucket_limit(b), max);
+        }
+        return max;
+    }
+};
+
+static void print_latency(const char *label, const LatencyHistogram &h) {
+    if (h.total == 0) return;
+    printf("  %-30s: avg %.2f  p50 %.2f  p99 %.2f  p99.9 %.2f  max %.2f us\n", label,
+           h.sum / 1000.0 / h.total, h.percentile(50) / 1000.0,
+           h.percentile(99) / 1000.0, h.percentile(99.9) / 1000.0, h.max / 1000.0);
+    if (g_report) {
+        std::string name(label);
+        report_metric((name + " avg").c_str(), "us", h.sum / 1000.0 / h.total);
+        report_metric((name + " p99").c_str(), "us", h.percentile(99) / 1000.0);
+    }
+}
+
+/* User + system CPU seconds consumed by the whole process so far */
+static double get_cpu_time(void) {
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return ru.ru_utime.tv_sec + ru.ru_utime.tv_usec / 1000000.0 +
+           ru.ru_stime.tv_sec + ru.ru_stime.tv_usec / 1000000.0;
 }
 
 static void print_header(const char *title) {
+    g_report_section = title;
+    g_report_subsection.clear();
     printf("\n" COLOR_CYAN);
     printf("════════════════════════════════════════════════════════\n");
     printf("  %s\n", title);
@@ -110,54 +1279,274 @@ static void print_header(const char *title) {
     printf(COLOR_RESET);
 }
 
-/* Configure RocksDB options for small database (matching KVStore) */
-static void configure_small_db_options(Options &options) {
-    // Basic settings
-    options.create_if_missing = true;
-    options.error_if_exists = false;
+/* Key and value of record i as written by the initial load */
+static int fill_key(char *buf, size_t size, long long i) {
+    return snprintf(buf, size, "key_%0*lld", FLAGS.key_width, i);
+}
 
-    // Disable compression (KVStore doesn't use compression)
-    options.compression = kNoCompression;
+static int fill_value(char *buf, size_t size, long long i) {
+    return snprintf(buf, size,
+                    "value_%0*lld_with_some_additional_data_to_make_it_realistic",
+                    FLAGS.key_width, i);
+}
 
-    // Block cache: 2MB (matching SQLite 2000 pages x 1KB)
-    BlockBasedTableOptions table_options;
-    table_options.block_cache = NewLRUCache(2 * 1024 * 1024);  // 2MB
-    table_options.block_size = 4 * 1024;  // 4KB blocks (closer to SQLite page size)
+/* WriteBatch rep_ bytes for n fill entries: 12-byte header, then a tag,
+** two length varints, a 12-byte key and a ~61-byte value per entry (both
+** grow with key_width). Batches reserved this size and Clear()ed between
+** commits never reallocate. */
+#define FILL_ENTRY_BYTES 80
 
-    // Disable bloom filters for small DB (saves memory)
-    table_options.filter_policy = nullptr;
+static size_t fill_batch_bytes(long long n) {
+    return 12 + (size_t)n * (FILL_ENTRY_BYTES + 2 * (FLAGS.key_width - 8));
+}
 
-    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+/* Which write last touched a key. Values >= VERSION_OVERWRITE_BASE
+** carry the overwrite op index, so every version maps to one exact
+** value string and the final state can be checked key by key. */
+enum : uint32_t {
+    VERSION_NONE = 0,
+    VERSION_LOADED,
+    VERSION_UPDATED,
+    VERSION_MIXED,
+    VERSION_OVERWRITE_BASE,
+};
 
-    // Small memtable (KVStore commits more frequently)
-    options.write_buffer_size = 2 * 1024 * 1024;  // 2MB memtable
-    options.max_write_buffer_number = 2;
-    options.min_write_buffer_number_to_merge = 1;
+static int format_value(char *buf, size_t size, long long i, uint32_t version) {
+    switch (version) {
+    case VERSION_LOADED:
+        return fill_value(buf, size, i);
+    case VERSION_UPDATED:
+        return snprintf(buf, size, "updated_value_%08lld", i);
+    case VERSION_MIXED:
+        return snprintf(buf, size, "mixed_value_%08lld", i);
+    default:
+        return snprintf(buf, size, "overwrite_value_%08lld_%012lld",
+                        i, (long long)(version - VERSION_OVERWRITE_BASE));
+    }
+}
 
-    // Reduce number of levels for small DB
-    options.num_levels = 4;
+/* ==================== Expected-State Shadow Model ==================== */
+/* Compact lock-free model of what the DB should contain: an existence
+** bitset plus the value version of the last write to each key, i.e.
+** num/8 + 4*num bytes. Writers update it only after their Write() has
+** succeeded, so readers compare against committed state. The version is
+** published before the existence bit (release/acquire), so a reader
+** that sees the bit also sees the version that goes with it. */
+class ExpectedState {
+public:
+    ExpectedState(long long num, uint32_t version)
+        : num_(num), words_((num + 63) / 64),
+          exists_(new std::atomic<uint64_t>[words_]),
+          versions_(new std::atomic<uint32_t>[num]) {
+        Reset(version);
+    }
 
-    // Smaller file sizes
-    options.target_file_size_base = 2 * 1024 * 1024;  // 2MB
-    options.max_bytes_for_level_base = 8 * 1024 * 1024;  // 8MB
+    /* Every key present with the given version (VERSION_NONE: all absent) */
+    void Reset(uint32_t version) {
+        uint64_t fill = version == VERSION_NONE ? 0 : ~0ULL;
+        for (long long w = 0; w < words_; w++) {
+            exists_[w].store(fill, std::memory_order_relaxed);
+        }
+        for (long long i = 0; i < num_; i++) {
+            versions_[i].store(version, std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+    }
 
-    // Reduce background threads for small DB
-    options.max_background_jobs = 2;
-    options.max_background_compactions = 1;
-    options.max_background_flushes = 1;
+    void Put(long long idx, uint32_t version) {
+        versions_[idx].store(version, std::memory_order_relaxed);
+        exists_[idx >> 6].fetch_or(1ULL << (idx & 63), std::memory_order_release);
+    }
 
-    // Optimize for sequential access patterns
-    options.allow_mmap_reads = false;
-    options.allow_mmap_writes = false;
+    void Delete(long long idx) {
+        exists_[idx >> 6].fetch_and(~(1ULL << (idx & 63)), std::memory_order_release);
+    }
 
-    // Reduce internal cache sizes
-    options.max_open_files = 100;  // Limit file descriptors
+    bool Exists(long long idx) const {
+        return (exists_[idx >> 6].load(std::memory_order_acquire) >> (idx & 63)) & 1;
+    }
 
-    // Statistics
-    options.statistics = CreateDBStatistics();
+    uint32_t Version(long long idx) const {
+        return versions_[idx].load(std::memory_order_relaxed);
+    }
 
-    printf("  Configuration:\n");
-    printf("    - Block cache:       2 MB\n");
+    size_t MemoryBytes() const {
+        return words_ * sizeof(uint64_t) + num_ * sizeof(uint32_t);
+    }
+
+private:
+    long long num_;
+    long long words_;
+    std::unique_ptr<std::atomic<uint64_t>[]> exists_;
+    std::unique_ptr<std::atomic<uint32_t>[]> versions_;
+};
+
+/* Live model, or NULL when --shadow_model is off */
+static ExpectedState *g_shadow = NULL;
+
+/* Model changes made by one WriteBatch; applied on successful commit */
+struct ShadowBatch {
+    std::vector<std::pair<long long, uint32_t>> ops;  // VERSION_NONE = delete
+
+    void Put(long long idx, uint32_t version) {
+        if (g_shadow) ops.emplace_back(idx, version);
+    }
+
+    void Delete(long long idx) {
+        if (g_shadow) ops.emplace_back(idx, VERSION_NONE);
+    }
+
+    void Commit(const Status &s) {
+        if (g_shadow && s.ok()) {
+            for (const auto &op : ops) {
+                if (op.second == VERSION_NONE) {
+                    g_shadow->Delete(op.first);
+                } else {
+                    g_shadow->Put(op.first, op.second);
+                }
+            }
+        }
+        ops.clear();
+    }
+};
+
+/* Reads are checked in batches of this many, so the timer pair that
+** measures the model's cost is paid once per batch rather than per read,
+** where it would cost more than the check it brackets */
+#define SHADOW_READ_BATCH 256
+
+/* Per-benchmark cost of the shadow model, plus the reads awaiting a check */
+struct ShadowStats {
+    double seconds = 0;
+    long long checks = 0;
+    long long mismatches = 0;
+
+    int pending = 0;
+    long long pending_idx[SHADOW_READ_BATCH];
+    bool pending_found[SHADOW_READ_BATCH];
+    std::string pending_values[SHADOW_READ_BATCH];
+};
+
+/* Compare one Get result against the model; true if it matches */
+static bool shadow_check_read(long long idx, bool found, const std::string &value) {
+    if (g_shadow->Exists(idx)) {
+        char expected[128];
+        int len = format_value(expected, sizeof(expected), idx, g_shadow->Version(idx));
+        return found && value.size() == (size_t)len &&
+               memcmp(value.data(), expected, len) == 0;
+    }
+    return !found;
+}
+
+/* Check every pending read against the model. Must run before the model
+** changes under them, i.e. before each shadow_commit and at phase end. */
+static void check_pending_reads(ShadowStats *stats) {
+    if (stats->pending == 0) return;
+
+    double t0 = get_time();
+    for (int k = 0; k < stats->pending; k++) {
+        long long idx = stats->pending_idx[k];
+        if (!shadow_check_read(idx, stats->pending_found[k], stats->pending_values[k])) {
+            if (stats->mismatches++ < 5) {
+                printf("    " COLOR_YELLOW "read mismatch" COLOR_RESET ": key_%0*lld\n",
+                       FLAGS.key_width, idx);
+            }
+        }
+    }
+    stats->checks += stats->pending;
+    stats->pending = 0;
+    stats->seconds += get_time() - t0;
+}
+
+/* Queue a Get result for checking. The value is swapped out rather than
+** copied; the caller's string is overwritten by its next Get anyway. */
+static void verified_read(long long idx, const Status &s, std::string *value,
+                          ShadowStats *stats) {
+    if (!FLAGS.verify_reads || read_failed(s)) return;
+
+    int k = stats->pending++;
+    stats->pending_idx[k] = idx;
+    stats->pending_found[k] = s.ok();
+    stats->pending_values[k].swap(*value);
+    if (stats->pending == SHADOW_READ_BATCH) check_pending_reads(stats);
+}
+
+static void shadow_commit(ShadowBatch *batch, const Status &s, ShadowStats *stats) {
+    if (!g_shadow) return;
+
+    check_pending_reads(stats);
+
+    double t0 = get_time();
+    batch->Commit(s);
+    stats->seconds += get_time() - t0;
+}
+
+static void print_shadow_stats(double elapsed, const ShadowStats &stats) {
+    if (!g_shadow) return;
+
+    printf("  %-30s: %.2f%% of run (%.3f sec)", "Shadow model overhead",
+           elapsed > 0 ? 100.0 * stats.seconds / elapsed : 0.0, stats.seconds);
+    if (stats.checks > 0) {
+        printf(", %lld reads checked, ", stats.checks);
+        if (stats.mismatches == 0) {
+            printf(COLOR_GREEN "0 mismatches" COLOR_RESET);
+        } else {
+            printf(COLOR_YELLOW "%lld mismatches" COLOR_RESET, stats.mismatches);
+        }
+    }
+    printf("\n");
+}
+
+/* Configure RocksDB options for small database (matching KVStore) */
+static void configure_small_db_options(Options &options, bool print_config = true) {
+    // Basic settings
+    options.create_if_missing = true;
+    options.error_if_exists = false;
+
+    // Disable compression (KVStore doesn't use compression)
+    options.compression = kNoCompression;
+
+    // Block cache: 2MB (matching SQLite 2000 pages x 1KB)
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewLRUCache(2 * 1024 * 1024);  // 2MB
+    table_options.block_size = 4 * 1024;  // 4KB blocks (closer to SQLite page size)
+
+    // Disable bloom filters for small DB (saves memory)
+    table_options.filter_policy = nullptr;
+
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+    // Small memtable (KVStore commits more frequently)
+    options.write_buffer_size = 2 * 1024 * 1024;  // 2MB memtable
+    options.max_write_buffer_number = 2;
+    options.min_write_buffer_number_to_merge = 1;
+
+    // Reduce number of levels for small DB
+    options.num_levels = 4;
+
+    // Smaller file sizes
+    options.target_file_size_base = 2 * 1024 * 1024;  // 2MB
+    options.max_bytes_for_level_base = 8 * 1024 * 1024;  // 8MB
+
+    // Reduce background threads for small DB
+    options.max_background_jobs = 2;
+    options.max_background_compactions = 1;
+    options.max_background_flushes = 1;
+
+    // Optimize for sequential access patterns
+    options.allow_mmap_reads = false;
+    options.allow_mmap_writes = false;
+
+    // Reduce internal cache sizes
+    options.max_open_files = 100;  // Limit file descriptors
+
+    // Statistics
+    options.statistics = CreateDBStatistics();
+
+    if (!print_config) return;
+
+    printf("  Configuration:\n");
+    printf("    - Block cache:       2 MB\n");
     printf("    - Write buffer:      2 MB\n");
     printf("    - Block size:        4 KB\n");
     printf("    - Compression:       Disabled\n");
@@ -168,291 +1557,2762 @@ static void configure_small_db_options(Options &options) {
     printf("    - Sync on commit:    Yes (matching SNKV)\n");
 }
 
+static uint64_t get_int_property(DB *db, const char *name) {
+    uint64_t value = 0;
+    db->GetIntProperty(Slice(name), &value);
+    return value;
+}
+
+/* ==================== Phase Property Snapshots ==================== */
+/* "L0:4 L1:10 L2:31" for the levels that hold files */
+static std::string level_shape(DB *db, int num_levels) {
+    std::string shape;
+    for (int level = 0; level < num_levels; level++) {
+        char prop[64], part[32];
+        snprintf(prop, sizeof(prop), "rocksdb.num-files-at-level%d", level);
+        std::string files;
+        if (db->GetProperty(prop, &files) && files != "0") {
+            snprintf(part, sizeof(part), "%sL%d:%s", shape.empty() ? "" : " ", level, files.c_str());
+            shape += part;
+        }
+    }
+    return shape.empty() ? "empty" : shape;
+}
+
+static double map_property_double(const std::map<std::string, std::string> &m,
+                                  const char *key) {
+    auto it = m.find(key);
+    return it == m.end() ? 0 : atof(it->second.c_str());
+}
+
+/* ==================== Background Thread Status ==================== */
+/* Polls Env::GetThreadList() and counts, per background pool, how many
+** thread observations found each activity ("Flush / FlushJob::Run",
+** "Compaction / CompactionJob::Run", ...) or idle. Report() prints the
+** shares since the last call, so it runs once per phase. */
+class ThreadStatusSampler {
+public:
+    /* False if this RocksDB build has no thread status support */
+    bool Start() {
+        std::vector<ThreadStatus> list;
+        if (!Env::Default()->GetThreadList(&list).ok()) return false;
+        stop_ = false;
+        thread_ = std::thread(&ThreadStatusSampler::Run, this);
+        return true;
+    }
+
+    ~ThreadStatusSampler() { Stop(); }
+
+    void Stop() {
+        if (!thread_.joinable()) return;
+        stop_ = true;
+        thread_.join();
+    }
+
+    void Report() {
+        std::lock_guard<std::mutex> lock(mu_);
+        if (rounds_ == 0) return;
+
+        printf("\n  Background threads (%llu samples every %d ms):\n",
+               (unsigned long long)rounds_, FLAGS.thread_status_ms);
+        for (int t = 0; t < ThreadStatus::NUM_THREAD_TYPES; t++) {
+            if (t == ThreadStatus::USER || observed_[t] == 0) continue;
+            const std::string &pool = ThreadStatus::GetThreadTypeName((ThreadStatus::ThreadType)t);
+            uint64_t busy = 0;
+            for (const auto &a : activity_[t]) busy += a.second;
+
+            printf("    %-26s: %5.1f%% busy, %.1f threads\n", pool.c_str(),
+                   100.0 * busy / observed_[t], (double)observed_[t] / rounds_);
+            for (const auto &a : activity_[t]) {
+                printf("      %-40s %5.1f%%\n", a.first.c_str(), 100.0 * a.second / observed_[t]);
+            }
+            report_metric((pool + " busy").c_str(), "%", 100.0 * busy / observed_[t]);
+        }
+
+        rounds_ = 0;
+        for (int t = 0; t < ThreadStatus::NUM_THREAD_TYPES; t++) {
+            observed_[t] = 0;
+            activity_[t].clear();
+        }
+    }
+
+private:
+    void Run() {
+        std::vector<ThreadStatus> list;
+        while (!stop_) {
+            list.clear();
+            if (Env::Default()->GetThreadList(&list).ok()) {
+                std::lock_guard<std::mutex> lock(mu_);
+                rounds_++;
+                for (const auto &ts : list) {
+                    int t = ts.thread_type;
+                    if (t == ThreadStatus::USER || t >= ThreadStatus::NUM_THREAD_TYPES) continue;
+                    observed_[t]++;
+                    if (ts.operation_type == ThreadStatus::OP_UNKNOWN) continue;  // idle
+
+                    std::string what = ThreadStatus::GetOperationName(ts.operation_type);
+                    if (ts.operation_stage != ThreadStatus::STAGE_UNKNOWN) {
+                        what += " / " + ThreadStatus::GetOperationStageName(ts.operation_stage);
+                    }
+                    activity_[t][what]++;
+                }
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(FLAGS.thread_status_ms));
+        }
+    }
+
+    std::mutex mu_;
+    uint64_t rounds_ = 0;
+    uint64_t observed_[ThreadStatus::NUM_THREAD_TYPES] = {};
+    std::map<std::string, uint64_t> activity_[ThreadStatus::NUM_THREAD_TYPES];
+    std::atomic<bool> stop_{false};
+    std::thread thread_;
+};
+
+static ThreadStatusSampler *g_thread_sampler = NULL;
+
+/* Printed after every main-suite phase so that a slow phase can be
+** traced to the LSM state it ran against. Compaction totals are
+** cumulative since open; compare consecutive phases. */
+static void dump_phase_properties(DB *db, const Options &options) {
+    if (g_thread_sampler) g_thread_sampler->Report();
+    if (FLAGS.phase_properties == "none") return;
+
+    std::map<std::string, std::string> cfstats;
+    db->GetMapProperty("rocksdb.cfstats", &cfstats);
+    double live_mb = get_int_property(db, "rocksdb.estimate-live-data-size") / (1024.0 * 1024.0);
+    double sst_mb = get_int_property(db, "rocksdb.total-sst-files-size") / (1024.0 * 1024.0);
+    double pinned_mb = get_int_property(db, "rocksdb.block-cache-pinned-usage") / (1024.0 * 1024.0);
+    uint64_t imm = get_int_property(db, "rocksdb.num-immutable-mem-table");
+    double comp_write_gb = map_property_double(cfstats, "compaction.Sum.WriteGB");
+    double comp_read_gb = map_property_double(cfstats, "compaction.Sum.ReadGB");
+    double comp_sec = map_property_double(cfstats, "compaction.Sum.CompSec");
+
+    printf("\n  Properties after phase:\n");
+    printf("    %-26s: %s\n", "Files per level", level_shape(db, options.num_levels).c_str());
+    printf("    %-26s: %.1f MB live of %.1f MB in SST files\n", "Data size", live_mb, sst_mb);
+    printf("    %-26s: %llu\n", "Immutable memtables", (unsigned long long)imm);
+    printf("    %-26s: %.1f MB\n", "Block cache pinned", pinned_mb);
+    printf("    %-26s: %.1f MB read, %.1f MB written, %.2f sec\n", "Compaction so far",
+           comp_read_gb * 1024, comp_write_gb * 1024, comp_sec);
+
+    report_metric("Live data", "MB", live_mb);
+    report_metric("SST files", "MB", sst_mb);
+    report_metric("Immutable memtables", "count", (double)imm);
+    report_metric("Block cache pinned", "MB", pinned_mb);
+    report_metric("Compaction written so far", "MB", comp_write_gb * 1024);
+
+    if (FLAGS.phase_properties == "full") {
+        std::string text;
+        if (db->GetProperty("rocksdb.levelstats", &text)) {
+            printf("\n%s", text.c_str());
+        }
+        if (db->GetProperty("rocksdb.stats", &text)) {
+            printf("\n%s", text.c_str());
+        }
+        printf("\n    rocksdb.cfstats:\n");
+        for (const auto &kv : cfstats) {
+            printf("      %-40s %s\n", kv.first.c_str(), kv.second.c_str());
+        }
+    }
+}
+
+/* ==================== Database Reuse ==================== */
+/* Replace db_path with the contents of checkpoint_dir. SST files are
+** immutable, so they are hard-linked when both directories share a
+** filesystem; everything else (MANIFEST, CURRENT, OPTIONS, WAL) is
+** copied because RocksDB rewrites it. */
+static bool restore_checkpoint(const std::string &checkpoint_dir,
+                               const std::string &db_path, const Options &options) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    double start = get_time();
+
+    if (!fs::is_directory(checkpoint_dir, ec)) {
+        fprintf(stderr, "Checkpoint not found: %s\n", checkpoint_dir.c_str());
+        return false;
+    }
+
+    DestroyDB(db_path, options);
+    fs::remove_all(db_path, ec);
+    fs::create_directories(db_path, ec);
+    if (ec) {
+        fprintf(stderr, "Failed to create %s: %s\n", db_path.c_str(), ec.message().c_str());
+        return false;
+    }
+
+    int linked = 0, copied = 0;
+    for (const auto &entry : fs::directory_iterator(checkpoint_dir)) {
+        fs::path dst = fs::path(db_path) / entry.path().filename();
+        bool is_sst = entry.path().extension() == ".sst";
+
+        if (is_sst) {
+            fs::create_hard_link(entry.path(), dst, ec);
+            if (!ec) {
+                linked++;
+                continue;
+            }
+            ec.clear();
+        }
+        fs::copy_file(entry.path(), dst, ec);
+        if (ec) {
+            fprintf(stderr, "Failed to copy %s: %s\n",
+                    entry.path().c_str(), ec.message().c_str());
+            return false;
+        }
+        copied++;
+    }
+
+    printf("  Restored checkpoint %s (%d linked, %d copied) in %.2f seconds\n",
+           checkpoint_dir.c_str(), linked, copied, get_time() - start);
+    return true;
+}
+
+/* The key width a DB was loaded with lives in a file inside its
+** directory (RocksDB ignores files it does not recognize) and is copied
+** into checkpoints, so a reused DB is read with the keys it holds */
+static std::string key_width_path(const std::string &dir) {
+    return dir + "/" KEY_WIDTH_FILE;
+}
+
+static void write_key_width(const std::string &dir) {
+    FILE *fp = fopen(key_width_path(dir).c_str(), "w");
+    if (!fp) {
+        fprintf(stderr, "Failed to record key width in %s\n", dir.c_str());
+        return;
+    }
+    fprintf(fp, "%d\n", FLAGS.key_width);
+    fclose(fp);
+}
+
+/* Adopt the reused DB's key width; false if its keys are too narrow
+** for --num, which means --num is larger than the load */
+static bool check_key_width(const std::string &dir) {
+    FILE *fp = fopen(key_width_path(dir).c_str(), "r");
+    int width = 0;
+    if (fp) {
+        if (fscanf(fp, "%d", &width) != 1) width = 0;
+        fclose(fp);
+    }
+
+    if (width <= 0) {
+        printf("  " COLOR_YELLOW "No key width recorded in %s, assuming %d digits"
+               COLOR_RESET "\n", dir.c_str(), FLAGS.key_width);
+    } else if (width < FLAGS.key_width) {
+        fprintf(stderr, "%s holds %d-digit keys; --num=%lld needs %d, so it exceeds the load\n",
+                dir.c_str(), width, FLAGS.num, FLAGS.key_width);
+        return false;
+    } else if (width > FLAGS.key_width) {
+        printf("  Using the DB's %d-digit keys\n", width);
+        FLAGS.key_width = width;
+    }
+    return true;
+}
+
+static void save_checkpoint(DB *db, const std::string &checkpoint_dir) {
+    Checkpoint *checkpoint = NULL;
+    double start = get_time();
+
+    Status s = Checkpoint::Create(db, &checkpoint);
+    if (s.ok()) {
+        s = checkpoint->CreateCheckpoint(checkpoint_dir);
+    }
+    delete checkpoint;
+
+    if (!s.ok()) {
+        fprintf(stderr, "Failed to save checkpoint %s: %s\n",
+                checkpoint_dir.c_str(), s.ToString().c_str());
+        return;
+    }
+    write_key_width(checkpoint_dir);
+    printf("  Saved checkpoint to %s in %.2f seconds\n",
+           checkpoint_dir.c_str(), get_time() - start);
+}
+
+/* ==================== Write Amplification ==================== */
+/* Counters sampled before and after a write phase; the difference gives
+** that phase's write amplification and stall time. */
+struct WriteAmpSnapshot {
+    uint64_t user_bytes;
+    uint64_t flush_bytes;
+    uint64_t compact_bytes;
+    uint64_t stall_micros;
+    uint64_t slowdowns;
+    uint64_t stops;
+    uint64_t pending_compaction_bytes;
+};
+
+static uint64_t map_property_value(const std::map<std::string, std::string> &m,
+                                   const char *key) {
+    auto it = m.find(key);
+    return it == m.end() ? 0 : strtoull(it->second.c_str(), NULL, 10);
+}
+
+static WriteAmpSnapshot take_write_amp_snapshot(DB *db, Statistics *stats) {
+    WriteAmpSnapshot snap = {};
+    if (stats) {
+        snap.user_bytes = stats->getTickerCount(BYTES_WRITTEN);
+        snap.flush_bytes = stats->getTickerCount(FLUSH_WRITE_BYTES);
+        snap.compact_bytes = stats->getTickerCount(COMPACT_WRITE_BYTES);
+        snap.stall_micros = stats->getTickerCount(STALL_MICROS);
+    }
+
+    std::map<std::string, std::string> cfstats;
+    if (db->GetMapProperty("rocksdb.cfstats", &cfstats)) {
+        snap.slowdowns = map_property_value(cfstats, "io_stalls.total_slowdown");
+        snap.stops = map_property_value(cfstats, "io_stalls.total_stop");
+    }
+    snap.pending_compaction_bytes =
+        get_int_property(db, "rocksdb.estimate-pending-compaction-bytes");
+    return snap;
+}
+
+/* Flush and compaction bytes still owed for this phase's writes are not
+** included, so amplification right after a fast fill reads low; the
+** remaining compaction debt is printed alongside. */
+static void print_write_amp(const WriteAmpSnapshot &before, const WriteAmpSnapshot &after,
+                            double elapsed) {
+    uint64_t user = after.user_bytes - before.user_bytes;
+    uint64_t flushed = after.flush_bytes - before.flush_bytes;
+    uint64_t compacted = after.compact_bytes - before.compact_bytes;
+    double stall_sec = (after.stall_micros - before.stall_micros) / 1e6;
+
+    printf("  %-30s: %.2fx (%.1f MB user, %.1f MB flushed, %.1f MB compacted)\n",
+           "Write amplification",
+           user > 0 ? (double)(flushed + compacted) / user : 0.0,
+           user / (1024.0 * 1024.0), flushed / (1024.0 * 1024.0),
+           compacted / (1024.0 * 1024.0));
+    printf("  %-30s: %.2f sec (%.1f%% of run), %llu slowdowns, %llu stops\n",
+           "Write stalls", stall_sec, elapsed > 0 ? 100.0 * stall_sec / elapsed : 0.0,
+           (unsigned long long)(after.slowdowns - before.slowdowns),
+           (unsigned long long)(after.stops - before.stops));
+    printf("  %-30s: %.1f MB\n", "Compaction debt at end",
+           after.pending_compaction_bytes / (1024.0 * 1024.0));
+}
+
+/* ==================== Key Order Permutation ==================== */
+/* Bijection on [0, n) without materializing a shuffled array, so random
+** fills scale to billions of keys. A 4-round Feistel network permutes
+** the smallest even-bit power-of-two domain covering n; cycle-walking
+** maps values >= n back into range. */
+struct KeyPermutation {
+    long long n;
+    int half_bits;
+    uint64_t half_mask;
+    uint64_t keys[4];
+
+    KeyPermutation(long long n_, uint64_t seed) : n(n_) {
+        int bits = 2;
+        while (bits < 62 && (1ULL << bits) < (uint64_t)n) bits += 2;
+        half_bits = bits / 2;
+        half_mask = (1ULL << half_bits) - 1;
+        for (int r = 0; r < 4; r++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            keys[r] = seed;
+        }
+    }
+
+    uint64_t round_fn(uint64_t x, uint64_t k) const {
+        x ^= k;
+        x *= 0x9E3779B97F4A7C15ULL;
+        x ^= x >> 29;
+        return x & half_mask;
+    }
+
+    long long operator()(long long pos) const {
+        uint64_t x = (uint64_t)pos;
+        do {
+            uint64_t left = x >> half_bits, right = x & half_mask;
+            for (int r = 0; r < 4; r++) {
+                uint64_t tmp = right;
+                right = left ^ round_fn(right, keys[r]);
+                left = tmp;
+            }
+            x = (left << half_bits) | right;
+        } while (x >= (uint64_t)n);
+        return (long long)x;
+    }
+};
+
+/* Key index written at position pos for the configured fill order */
+struct FillOrder {
+    long long num;
+    long long run;
+    long long full_runs;
+    KeyPermutation perm;
+
+    FillOrder(long long n, long long run_length, uint64_t seed)
+        : num(n), run(run_length), full_runs(n / run_length),
+          perm(std::max(1LL, n / run_length), seed) {}
+
+    long long operator()(long long pos) const {
+        // The short tail run (if any) stays in place
+        if (pos >= full_runs * run) return pos;
+        return perm(pos / run) * run + pos % run;
+    }
+};
+
 /* ==================== BENCHMARK 1: Sequential Writes ==================== */
-static void bench_sequential_writes(DB *db) {
-    print_header("BENCHMARK 1: Sequential Writes");
-    printf("  Writing %d records in batches of %d...\n\n", NUM_RECORDS, BATCH_SIZE);
+static void bench_sequential_writes(DB *db, Statistics *stats) {
+    long long run_length = 1;
+    const char *title = "BENCHMARK 1: Sequential Writes";
+    const char *label = "Sequential writes";
+
+    if (FLAGS.fill_order == "random") {
+        title = "BENCHMARK 1: Random-Order Writes (fillrandom)";
+        label = "Random-order writes";
+    } else if (FLAGS.fill_order == "partial") {
+        run_length = FLAGS.fill_run_length;
+        title = "BENCHMARK 1: Partially-Sorted Writes";
+        label = "Partially-sorted writes";
+    }
+
+    print_header(title);
+    printf("  Writing %lld records in batches of %d...\n", FLAGS.num, BATCH_SIZE);
+    if (FLAGS.fill_order == "partial") {
+        printf("  Sorted runs of %lld keys in random run order\n", run_length);
+    }
+    printf("\n");
 
     char key[32], value[128];
-    int i;
+    long long i;
+    double start, end;
+    long long errors = 0;
+    bool sequential = FLAGS.fill_order == "sequential";
+    FillOrder order(FLAGS.num, run_length, stream_seed(STREAM_FILL));
+
+    WriteOptions write_opts;
+    write_opts.sync = true;  // Match SNKV's per-commit fsync
+
+    WriteAmpSnapshot before = take_write_amp_snapshot(db, stats);
+    start = get_time();
+
+    auto fill_and_write = [&](WriteBatch &batch) {
+        for (int j = 0; j < BATCH_SIZE && i < FLAGS.num; j++, i++) {
+            long long idx = sequential ? i : order(i);
+            int klen = fill_key(key, sizeof(key), idx);
+            int vlen = fill_value(value, sizeof(value), idx);
+
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+        }
+
+        if (!db->Write(write_opts, &batch).ok()) errors++;
+    };
+
+    WriteBatch reused(FLAGS.reuse_batch ? fill_batch_bytes(BATCH_SIZE) : 0);
+    for (i = 0; i < FLAGS.num; ) {
+        if (FLAGS.reuse_batch) {
+            reused.Clear();
+            fill_and_write(reused);
+        } else {
+            WriteBatch batch;
+            fill_and_write(batch);
+        }
+    }
+
+    end = get_time();
+    WriteAmpSnapshot after = take_write_amp_snapshot(db, stats);
+
+    print_result(label, end - start, FLAGS.num);
+    record_errors(label, errors);
+    print_write_amp(before, after, end - start);
+}
+
+/* ==================== BENCHMARK 1 (alt): Parallel Load ==================== */
+/* Progress bar redrawn in place from the main thread while loaders run */
+static void print_load_progress(long long done, long long total, double elapsed) {
+    const int width = 40;
+    int filled = (int)(width * done / total);
+    char count_buf[32], rate_buf[32];
+
+    format_number(done, count_buf, sizeof(count_buf));
+    format_number(elapsed > 0 ? (long long)(done / elapsed) : 0, rate_buf, sizeof(rate_buf));
+
+    printf("\r  [");
+    for (int i = 0; i < width; i++) putchar(i < filled ? '#' : '.');
+    printf("] %5.1f%%  %s keys  %s keys/sec  ",
+           100.0 * done / total, count_buf, rate_buf);
+    fflush(stdout);
+}
+
+/* Thread t owns the sorted key range [first, last) */
+static void load_range_wal_off(DB *db, long long first, long long last,
+                               std::atomic<long long> *done, std::atomic<int> *errors) {
+    char key[32], value[128];
+    WriteOptions write_opts;
+    write_opts.disableWAL = true;  // Durability comes from the final flush
+
+    long long i = first;
+    // Entries added, or -1 once a write has failed
+    auto fill_and_write = [&](WriteBatch &batch) {
+        int n = 0;
+        for (; n < BATCH_SIZE && i < last; n++, i++) {
+            int klen = fill_key(key, sizeof(key), i);
+            int vlen = fill_value(value, sizeof(value), i);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+        }
+        return db->Write(write_opts, &batch).ok() ? n : -1;
+    };
+
+    WriteBatch reused(FLAGS.reuse_batch ? fill_batch_bytes(BATCH_SIZE) : 0);
+    while (i < last) {
+        int n;
+        if (FLAGS.reuse_batch) {
+            reused.Clear();
+            n = fill_and_write(reused);
+        } else {
+            WriteBatch batch;
+            n = fill_and_write(batch);
+        }
+
+        if (n < 0) {
+            errors->fetch_add(1);
+            return;
+        }
+        done->fetch_add(n, std::memory_order_relaxed);
+    }
+}
+
+/* Build one or more SSTs for [first, last), rolling at ingest_file_mb */
+static void load_range_sst(const Options *options, const std::string &dir, int t,
+                           long long first, long long last,
+                           std::vector<std::string> *files,
+                           std::atomic<long long> *done, std::atomic<int> *errors) {
+    char key[32], value[128];
+    const uint64_t file_limit = (uint64_t)FLAGS.ingest_file_mb * 1024 * 1024;
+    SstFileWriter writer(EnvOptions(), *options);
+    bool open = false;
+    long long pending = 0;
+
+    for (long long i = first; i < last; i++) {
+        if (!open) {
+            char name[64];
+            snprintf(name, sizeof(name), "/load_%03d_%05zu.sst", t, files->size());
+            files->push_back(dir + name);
+            if (!writer.Open(files->back()).ok()) {
+                errors->fetch_add(1);
+                return;
+            }
+            open = true;
+        }
+
+        int klen = fill_key(key, sizeof(key), i);
+        int vlen = fill_value(value, sizeof(value), i);
+        if (!writer.Put(Slice(key, klen), Slice(value, vlen)).ok()) {
+            errors->fetch_add(1);
+            return;
+        }
+
+        if (++pending == BATCH_SIZE) {
+            done->fetch_add(pending, std::memory_order_relaxed);
+            pending = 0;
+        }
+        if (writer.FileSize() >= file_limit) {
+            if (!writer.Finish().ok()) {
+                errors->fetch_add(1);
+                return;
+            }
+            open = false;
+        }
+    }
+
+    if (open && !writer.Finish().ok()) {
+        errors->fetch_add(1);
+    }
+    done->fetch_add(pending, std::memory_order_relaxed);
+}
+
+static void bench_parallel_load(DB *db, const Options &options) {
+    char title[96];
+    snprintf(title, sizeof(title), "BENCHMARK 1: Parallel Load (%s, %d threads)",
+             FLAGS.loader.c_str(), FLAGS.load_threads);
+    print_header(title);
+    printf("  Loading %lld records...\n\n", FLAGS.num);
+
+    const int nthreads = FLAGS.load_threads;
+    const bool ingest = FLAGS.loader == "ingest";
+    const std::string sst_dir = FLAGS.db + "_ingest";
+    std::vector<std::vector<std::string>> files(nthreads);
+    std::vector<std::thread> threads;
+    std::atomic<long long> done(0);
+    std::atomic<int> errors(0);
     double start, end;
 
+    if (ingest) {
+        std::error_code ec;
+        std::filesystem::remove_all(sst_dir, ec);
+        std::filesystem::create_directories(sst_dir, ec);
+    }
+
+    start = get_time();
+
+    for (int t = 0; t < nthreads; t++) {
+        long long first = FLAGS.num * t / nthreads;
+        long long last = FLAGS.num * (t + 1) / nthreads;
+        if (ingest) {
+            threads.emplace_back(load_range_sst, &options, sst_dir, t, first, last,
+                                 &files[t], &done, &errors);
+        } else {
+            threads.emplace_back(load_range_wal_off, db, first, last, &done, &errors);
+        }
+    }
+
+    while (done.load() < FLAGS.num && errors.load() == 0) {
+        print_load_progress(done.load(), FLAGS.num, get_time() - start);
+        usleep(200 * 1000);
+    }
+    for (auto &th : threads) th.join();
+    print_load_progress(done.load(), FLAGS.num, get_time() - start);
+    printf("\n");
+
+    double generate_end = get_time();
+    Status s;
+    if (errors.load() > 0) {
+        s = Status::Corruption("loader thread failed");
+    } else if (ingest) {
+        // Ranges are disjoint and ordered by thread, so the files never
+        // overlap and can all go to the bottommost level
+        std::vector<std::string> all_files;
+        for (const auto &f : files) all_files.insert(all_files.end(), f.begin(), f.end());
+
+        IngestExternalFileOptions ingest_opts;
+        ingest_opts.move_files = true;
+        s = db->IngestExternalFile(all_files, ingest_opts);
+        printf("  Ingested %zu SST files in %.2f seconds\n",
+               all_files.size(), get_time() - generate_end);
+    } else {
+        FlushOptions flush_opts;
+        flush_opts.wait = true;
+        s = db->Flush(flush_opts);
+        printf("  Final flush took %.2f seconds\n", get_time() - generate_end);
+    }
+
+    end = get_time();
+
+    if (ingest) {
+        std::error_code ec;
+        std::filesystem::remove_all(sst_dir, ec);
+    }
+    if (!s.ok()) {
+        fprintf(stderr, "  Parallel load failed: %s\n", s.ToString().c_str());
+    }
+
+    print_result("Parallel load", end - start, FLAGS.num);
+    record_errors("Parallel load", errors.load() + (s.ok() ? 0 : 1));
+    printf("  %-30s: %.1f MB/sec\n", "Load rate",
+           get_int_property(db, "rocksdb.total-sst-files-size") /
+               (1024.0 * 1024.0) / (end - start));
+}
+
+/* ==================== BENCHMARK 2: Random Reads ==================== */
+static double run_random_reads(DB *db, int num_reads, long long *errors,
+                               ShadowStats *shadow) {
+    static uint64_t pass = 0;
+    char key[32];
+    std::string value;
+    int i;
+    double start, end;
+    BenchRandom rng(stream_seed(STREAM_READS) + pass++);
+    static const ZipfGenerator *zipf =
+        FLAGS.read_dist == "zipf" ? new ZipfGenerator(FLAGS.num, FLAGS.zipf_theta) : NULL;
+    static const KeyPermutation scatter(FLAGS.num, stream_seed(STREAM_READ_SCATTER));
+
+    start = get_time();
+
+    ReadOptions read_opts;
+    for (i = 0; i < num_reads; i++) {
+        long long idx = zipf ? scatter(zipf->next(rng)) : rng.uniform(FLAGS.num);
+        fill_key(key, sizeof(key), idx);
+
+        Status s = db->Get(read_opts, Slice(key, strlen(key)), &value);
+        if (read_failed(s)) (*errors)++;
+        verified_read(idx, s, &value, shadow);
+    }
+    check_pending_reads(shadow);
+
+    end = get_time();
+
+    return end - start;
+}
+
+/* Returns ops/sec so the steady-state pass can be compared against it */
+static double bench_random_reads(DB *db) {
+    print_header("BENCHMARK 2: Random Reads");
+    if (FLAGS.read_dist == "zipf") {
+        printf("  Reading %d zipf-distributed records (theta %.2f)...\n\n",
+               NUM_READS, FLAGS.zipf_theta);
+    } else {
+        printf("  Reading %d random records...\n\n", NUM_READS);
+    }
+
+    long long errors = 0;
+    ShadowStats shadow;
+    double elapsed = run_random_reads(db, NUM_READS, &errors, &shadow);
+    const char *label =
+        FLAGS.steady_state == "none" ? "Random reads" : "Random reads (fresh)";
+
+    print_result(label, elapsed, NUM_READS);
+    record_errors(label, errors);
+    print_shadow_stats(elapsed, shadow);
+    return NUM_READS / elapsed;
+}
+
+/* ==================== Steady-State Detection ==================== */
+/* Wait until no flush or compaction is pending or running. Requires
+** several consecutive idle polls because a finished flush can
+** immediately schedule a compaction. */
+static bool wait_for_quiesce(DB *db) {
+    const int required_idle_polls = 5;
+    int idle_polls = 0;
+    double start = get_time();
+
+    while (get_time() - start < FLAGS.steady_timeout_sec) {
+        uint64_t pending = get_int_property(db, "rocksdb.compaction-pending");
+        uint64_t compactions = get_int_property(db, "rocksdb.num-running-compactions");
+        uint64_t flush_pending = get_int_property(db, "rocksdb.mem-table-flush-pending");
+        uint64_t flushes = get_int_property(db, "rocksdb.num-running-flushes");
+
+        if (pending == 0 && compactions == 0 && flush_pending == 0 && flushes == 0) {
+            if (++idle_polls >= required_idle_polls) {
+                printf("  Compaction quiesced after %.2f seconds\n", get_time() - start);
+                return true;
+            }
+        } else {
+            idle_polls = 0;
+        }
+        usleep(100 * 1000);
+    }
+
+    printf("  Compaction still active after %.0f seconds (timeout)\n",
+           FLAGS.steady_timeout_sec);
+    return false;
+}
+
+/* Run read windows until the coefficient of variation of throughput
+** over the last steady_windows windows drops below steady_cv_pct. */
+static bool wait_for_read_variance(DB *db) {
+    std::vector<double> window;
+    double start = get_time();
+    int windows_run = 0;
+
+    while (get_time() - start < FLAGS.steady_timeout_sec) {
+        long long errors = 0;
+        ShadowStats shadow;
+        double elapsed = run_random_reads(db, FLAGS.steady_window_ops, &errors, &shadow);
+        windows_run++;
+
+        window.push_back(FLAGS.steady_window_ops / elapsed);
+        if ((int)window.size() > FLAGS.steady_windows) {
+            window.erase(window.begin());
+        }
+        if ((int)window.size() < FLAGS.steady_windows) {
+            continue;
+        }
+
+        double sum = 0, sq = 0;
+        for (double w : window) sum += w;
+        double mean = sum / window.size();
+        for (double w : window) sq += (w - mean) * (w - mean);
+        double cv_pct = 100.0 * sqrt(sq / window.size()) / mean;
+
+        if (cv_pct < FLAGS.steady_cv_pct) {
+            printf("  Throughput CV %.2f%% after %d windows (%.2f seconds)\n",
+                   cv_pct, windows_run, get_time() - start);
+            return true;
+        }
+    }
+
+    printf("  Throughput did not stabilize within %.0f seconds (timeout)\n",
+           FLAGS.steady_timeout_sec);
+    return false;
+}
+
+static void bench_random_reads_steady(DB *db, double fresh_ops_per_sec) {
+    print_header("BENCHMARK 2b: Random Reads (Steady-State)");
+    printf("  Waiting for steady state (%s)...\n", FLAGS.steady_state.c_str());
+
+    if (FLAGS.steady_state == "quiesce") {
+        wait_for_quiesce(db);
+    } else {
+        wait_for_read_variance(db);
+    }
+
+    printf("  Reading %d random records...\n\n", NUM_READS);
+    long long errors = 0;
+    ShadowStats shadow;
+    double elapsed = run_random_reads(db, NUM_READS, &errors, &shadow);
+    print_result("Random reads (steady)", elapsed, NUM_READS);
+    record_errors("Random reads (steady)", errors);
+    print_shadow_stats(elapsed, shadow);
+
+    double steady_ops_per_sec = NUM_READS / elapsed;
+    printf("  %-30s: %+.1f%%\n", "Steady vs fresh",
+           100.0 * (steady_ops_per_sec - fresh_ops_per_sec) / fresh_ops_per_sec);
+}
+
+/* ==================== BENCHMARK 3: Sequential Scan ==================== */
+static void bench_sequential_scan(DB *db) {
+    print_header("BENCHMARK 3: Sequential Scan");
+    printf("  Scanning all records...\n\n");
+
+    int count = 0;
+    double start, end;
+
+    start = get_time();
+
+    ReadOptions read_opts;
+    Iterator* it = db->NewIterator(read_opts);
+
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        Slice key = it->key();
+        Slice value = it->value();
+        count++;
+    }
+    long long errors = it->status().ok() ? 0 : 1;
+
+    delete it;
+
+    end = get_time();
+
+    print_result("Sequential scan", end - start, count);
+    record_errors("Sequential scan", errors);
+}
+
+/* ==================== BENCHMARK 4: Random Updates ==================== */
+static void bench_random_updates(DB *db) {
+    print_header("BENCHMARK 4: Random Updates");
+    printf("  Updating %d random records...\n\n", NUM_UPDATES);
+
+    char key[32], value[128];
+    int i;
+    double start, end;
+
+    BenchRandom rng(stream_seed(STREAM_UPDATES));
+
+    start = get_time();
+
+    WriteBatch batch;
+    ShadowBatch shadow_batch;
+    ShadowStats shadow;
+
+    for (i = 0; i < NUM_UPDATES; i++) {
+        long long idx = rng.uniform(FLAGS.num);
+        fill_key(key, sizeof(key), idx);
+        format_value(value, sizeof(value), idx, VERSION_UPDATED);
+
+        batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
+        shadow_batch.Put(idx, VERSION_UPDATED);
+    }
+
+    WriteOptions write_opts;
+    write_opts.sync = true;  // Match SNKV's per-commit fsync
+    Status s = db->Write(write_opts, &batch);
+    shadow_commit(&shadow_batch, s, &shadow);
+
+    end = get_time();
+
+    print_result("Random updates", end - start, NUM_UPDATES);
+    record_errors("Random updates", s.ok() ? 0 : 1);
+    print_shadow_stats(end - start, shadow);
+}
+
+/* ==================== BENCHMARK 5: Random Deletes ==================== */
+static void bench_random_deletes(DB *db) {
+    print_header("BENCHMARK 5: Random Deletes");
+    printf("  Deleting %d random records...\n\n", NUM_DELETES);
+
+    char key[32];
+    int i;
+    double start, end;
+
+    BenchRandom rng(stream_seed(STREAM_DELETES));
+
+    start = get_time();
+
+    WriteBatch batch;
+    ShadowBatch shadow_batch;
+    ShadowStats shadow;
+
+    for (i = 0; i < NUM_DELETES; i++) {
+        long long idx = rng.uniform(FLAGS.num);
+        fill_key(key, sizeof(key), idx);
+        batch.Delete(Slice(key, strlen(key)));
+        shadow_batch.Delete(idx);
+    }
+
+    WriteOptions write_opts;
+    write_opts.sync = true;  // Match SNKV's per-commit fsync
+    Status s = db->Write(write_opts, &batch);
+    shadow_commit(&shadow_batch, s, &shadow);
+
+    end = get_time();
+
+    print_result("Random deletes", end - start, NUM_DELETES);
+    record_errors("Random deletes", s.ok() ? 0 : 1);
+    print_shadow_stats(end - start, shadow);
+}
+
+/* ==================== BENCHMARK 6: Exists Checks ==================== */
+static void bench_exists_checks(DB *db) {
+    print_header("BENCHMARK 6: Exists Checks");
+    printf("  Checking existence of %d keys...\n\n", NUM_READS);
+
+    char key[32];
+    std::string value;
+    int i;
+    long long errors = 0;
+    double start, end;
+    ShadowStats shadow;
+    BenchRandom rng(stream_seed(STREAM_EXISTS));
+
+    start = get_time();
+
+    ReadOptions read_opts;
+    for (i = 0; i < NUM_READS; i++) {
+        long long idx = rng.uniform(FLAGS.num);
+        fill_key(key, sizeof(key), idx);
+
+        // Note: RocksDB has no direct "exists" API equivalent to
+        // kvstore_exists(). db->Get() reads the full value.
+        // SNKV's kvstore_exists() only checks key presence without
+        // reading the value, giving it a natural advantage here.
+        Status s = db->Get(read_opts, Slice(key, strlen(key)), &value);
+        if (read_failed(s)) errors++;
+        verified_read(idx, s, &value, &shadow);
+    }
+    check_pending_reads(&shadow);
+
+    end = get_time();
+
+    print_result("Exists checks", end - start, NUM_READS);
+    record_errors("Exists checks", errors);
+    print_shadow_stats(end - start, shadow);
+}
+
+/* ==================== BENCHMARK 7: Mixed Workload ==================== */
+static void bench_mixed_workload(DB *db) {
+    print_header("BENCHMARK 7: Mixed Workload");
+    printf("  70%% reads, 20%% writes, 10%% deletes...\n\n");
+
+    int total_ops = NUM_MIXED_OPS;
+    char key[32], value[128];
+    std::string val;
+    int i;
+    long long errors = 0;
+    double start, end;
+    BenchRandom rng(stream_seed(STREAM_MIXED));
+    ShadowBatch shadow_batch;
+    ShadowStats shadow;
+
+    start = get_time();
+
+    WriteBatch batch;
+    WriteOptions write_opts;
+    write_opts.sync = true;  // Match SNKV's per-commit fsync
+    ReadOptions read_opts;
+
+    for (i = 0; i < total_ops; i++) {
+        long long idx = rng.uniform(FLAGS.num);
+        int op = (int)rng.uniform(100);
+
+        fill_key(key, sizeof(key), idx);
+
+        if (op < 70) {
+            /* Read */
+            // Checked against committed state: writes still sitting in
+            // the open batch are not visible to Get either
+            Status s = db->Get(read_opts, Slice(key, strlen(key)), &val);
+            if (read_failed(s)) errors++;
+            verified_read(idx, s, &val, &shadow);
+        } else if (op < 90) {
+            /* Write */
+            format_value(value, sizeof(value), idx, VERSION_MIXED);
+            batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
+            shadow_batch.Put(idx, VERSION_MIXED);
+        } else {
+            /* Delete */
+            batch.Delete(Slice(key, strlen(key)));
+            shadow_batch.Delete(idx);
+        }
+
+        // Flush batch periodically (every 100 write ops, matching commit cadence)
+        if (batch.Count() > 100) {
+            Status s = db->Write(write_opts, &batch);
+            if (!s.ok()) errors++;
+            shadow_commit(&shadow_batch, s, &shadow);
+            batch.Clear();
+        }
+    }
+
+    // Flush remaining operations
+    if (batch.Count() > 0) {
+        Status s = db->Write(write_opts, &batch);
+        if (!s.ok()) errors++;
+        shadow_commit(&shadow_batch, s, &shadow);
+    }
+    check_pending_reads(&shadow);
+
+    end = get_time();
+
+    print_result("Mixed workload", end - start, total_ops);
+    record_errors("Mixed workload", errors);
+    print_shadow_stats(end - start, shadow);
+}
+
+/* ==================== BENCHMARK 8: Bulk Insert ==================== */
+static void bench_bulk_insert(void) {
+    print_header("BENCHMARK 8: Bulk Insert (Single Transaction)");
+    printf("  Inserting %lld records in one transaction...\n\n", FLAGS.num);
+
+    char key[32], value[128];
+    long long i;
+    double start, end;
+
+    // Open separate database for this test
+    Options options;
+    configure_small_db_options(options);
+
+    DB* db;
+    Status status = DB::Open(options, "benchmark_bulk_rocksdb", &db);
+    if (!status.ok()) {
+        fprintf(stderr, "Failed to open database for bulk insert\n");
+        return;
+    }
+
+    start = get_time();
+
+    // With --reuse_batch, reserve the whole batch up front rather than
+    // growing rep_ by doubling (40 bytes per entry at key_width 8: tag, two
+    // varints, 17-byte key, 19-byte value)
+    WriteBatch batch(FLAGS.reuse_batch ?
+                     12 + (size_t)FLAGS.num * (40 + 2 * (FLAGS.key_width - 8)) : 0);
+
+    for (i = 0; i < FLAGS.num; i++) {
+        snprintf(key, sizeof(key), "bulk_key_%0*lld", FLAGS.key_width, i);
+        snprintf(value, sizeof(value), "bulk_value_%0*lld", FLAGS.key_width, i);
+        batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
+    }
+
+    WriteOptions write_opts;
+    write_opts.sync = true;  // Match SNKV's per-commit fsync
+    Status s = db->Write(write_opts, &batch);
+
+    end = get_time();
+
+    delete db;
+
+    // Cleanup
+    DestroyDB("benchmark_bulk_rocksdb", options);
+
+    print_result("Bulk insert", end - start, FLAGS.num);
+    record_errors("Bulk insert", s.ok() ? 0 : 1);
+}
+
+/* ==================== BENCHMARK 9: Sustained Overwrite ==================== */
+/* Space held by overwritten versions that compaction has not dropped yet */
+static uint64_t obsolete_version_bytes(DB *db) {
+    uint64_t total = get_int_property(db, "rocksdb.total-sst-files-size");
+    uint64_t live = get_int_property(db, "rocksdb.estimate-live-data-size");
+    return total > live ? total - live : 0;
+}
+
+static void bench_overwrite(DB *db, Statistics *stats) {
+    print_header("BENCHMARK 9: Sustained Overwrite");
+
+    const long long ws_keys =
+        std::max(1LL, (long long)(FLAGS.num * FLAGS.overwrite_working_set));
+    char ops_buf[32], ws_buf[32];
+    format_number(FLAGS.overwrite_ops, ops_buf, sizeof(ops_buf));
+    format_number(ws_keys, ws_buf, sizeof(ws_buf));
+    printf("  %s updates over a working set of %s keys (%.1f%%),\n",
+           ops_buf, ws_buf, 100.0 * FLAGS.overwrite_working_set);
+    printf("  batches of %d, sync=%s\n\n", FLAGS.overwrite_batch,
+           FLAGS.overwrite_sync ? "yes" : "no");
+
+    char key[32], value[128];
+    double start, end;
+    long long errors = 0;
+    KeyPermutation scatter(FLAGS.num, stream_seed(STREAM_OVERWRITE_SCATTER));
+    BenchRandom rng(stream_seed(STREAM_OVERWRITE));
+    std::vector<double> interval_rates;
+    ShadowBatch shadow_batch;
+    ShadowStats shadow;
+
+    WriteOptions write_opts;
+    write_opts.sync = FLAGS.overwrite_sync;
+
+    printf("  %10s %14s %14s %14s\n", "elapsed", "ops/sec", "debt MB", "obsolete MB");
+
+    WriteAmpSnapshot before = take_write_amp_snapshot(db, stats);
+    start = get_time();
+    double interval_start = start;
+    long long interval_ops = 0;
+
+    for (long long i = 0; i < FLAGS.overwrite_ops; ) {
+        WriteBatch batch;
+        int n = 0;
+
+        for (; n < FLAGS.overwrite_batch && i < FLAGS.overwrite_ops; n++, i++) {
+            long long idx = scatter(rng.uniform(ws_keys));
+            int klen = fill_key(key, sizeof(key), idx);
+            int vlen = format_value(value, sizeof(value), idx,
+                                    VERSION_OVERWRITE_BASE + (uint32_t)i);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+            shadow_batch.Put(idx, VERSION_OVERWRITE_BASE + (uint32_t)i);
+        }
+
+        Status s = db->Write(write_opts, &batch);
+        if (!s.ok()) errors++;
+        shadow_commit(&shadow_batch, s, &shadow);
+        interval_ops += n;
+
+        double now = get_time();
+        if (now - interval_start >= FLAGS.overwrite_report_sec) {
+            double rate = interval_ops / (now - interval_start);
+            interval_rates.push_back(rate);
+            printf("  %9.0fs %14.0f %14.1f %14.1f\n", now - start, rate,
+                   get_int_property(db, "rocksdb.estimate-pending-compaction-bytes") /
+                       (1024.0 * 1024.0),
+                   obsolete_version_bytes(db) / (1024.0 * 1024.0));
+            interval_start = now;
+            interval_ops = 0;
+        }
+    }
+
+    end = get_time();
+    WriteAmpSnapshot after = take_write_amp_snapshot(db, stats);
+
+    printf("\n");
+    print_result("Overwrite (overall)", end - start, FLAGS.overwrite_ops);
+    record_errors("Overwrite", errors);
+    print_shadow_stats(end - start, shadow);
+
+    // Sustained rate: mean and minimum over the second half of the
+    // intervals, once compaction has had time to fall behind
+    if (interval_rates.size() >= 2) {
+        size_t half = interval_rates.size() / 2;
+        double sum = 0, min_rate = interval_rates[half];
+        for (size_t k = half; k < interval_rates.size(); k++) {
+            sum += interval_rates[k];
+            min_rate = std::min(min_rate, interval_rates[k]);
+        }
+        char rate_buf[32], min_buf[32];
+        format_number((long long)(sum / (interval_rates.size() - half)), rate_buf, sizeof(rate_buf));
+        format_number((long long)min_rate, min_buf, sizeof(min_buf));
+        printf("  %-30s: " COLOR_GREEN "%s ops/sec" COLOR_RESET " (min interval %s)\n",
+               "Overwrite (sustained)", rate_buf, min_buf);
+    }
+
+    print_write_amp(before, after, end - start);
+    printf("  %-30s: %.1f MB\n", "Obsolete-version space",
+           obsolete_version_bytes(db) / (1024.0 * 1024.0));
+}
+
+/* ==================== BENCHMARK 10: Async MultiGet ==================== */
+/* Few threads with many lookups in flight each (MultiGet with async_io,
+** which RocksDB serves through io_uring and coroutines when built with
+** USE_COROUTINES; otherwise it quietly falls back to synchronous reads)
+** versus the classic one-blocking-Get-per-thread model. */
+static void multiget_worker(DB *db, long long ops, uint64_t seed,
+                            LatencyHistogram *batch_hist, std::atomic<long long> *errors) {
+    const int n = FLAGS.multiget_batch;
+    std::vector<std::string> keys(n);
+    std::vector<Slice> key_slices(n);
+    std::vector<PinnableSlice> values(n);
+    std::vector<Status> statuses(n);
+    BenchRandom rng(seed);
+    char key[32];
+
+    ReadOptions read_opts;
+    read_opts.async_io = true;
+    read_opts.optimize_multiget_for_io = true;
+
+    for (long long done = 0; done < ops; done += n) {
+        for (int k = 0; k < n; k++) {
+            int klen = fill_key(key, sizeof(key), rng.uniform(FLAGS.num));
+            keys[k].assign(key, klen);
+            key_slices[k] = Slice(keys[k]);
+            values[k].Reset();
+        }
+
+        uint64_t t0 = now_ns();
+        db->MultiGet(read_opts, db->DefaultColumnFamily(), n, key_slices.data(),
+                     values.data(), statuses.data());
+        batch_hist->add(elapsed_ns(t0));
+
+        for (int k = 0; k < n; k++) {
+            if (read_failed(statuses[k])) errors->fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+static void get_worker(DB *db, long long ops, uint64_t seed,
+                       LatencyHistogram *hist, std::atomic<long long> *errors) {
+    BenchRandom rng(seed);
+    ReadOptions read_opts;
+    std::string value;
+    char key[32];
+
+    for (long long i = 0; i < ops; i++) {
+        int klen = fill_key(key, sizeof(key), rng.uniform(FLAGS.num));
+
+        uint64_t t0 = now_ns();
+        Status s = db->Get(read_opts, Slice(key, klen), &value);
+        hist->add(elapsed_ns(t0));
+
+        if (read_failed(s)) errors->fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+/* Forward or async-prefetching scans of scan_len keys from random starts */
+static void scan_worker(DB *db, bool async_io, int scans, int scan_len, uint64_t seed,
+                        LatencyHistogram *hist, long long *bytes) {
+    BenchRandom rng(seed);
+    ReadOptions read_opts;
+    read_opts.async_io = async_io;
+    read_opts.adaptive_readahead = true;
+    char key[32];
+
+    Iterator *it = db->NewIterator(read_opts);
+    for (int i = 0; i < scans; i++) {
+        int klen = fill_key(key, sizeof(key), rng.uniform(FLAGS.num));
+
+        uint64_t t0 = now_ns();
+        it->Seek(Slice(key, klen));
+        for (int k = 0; k < scan_len && it->Valid(); k++, it->Next()) {
+            *bytes += it->key().size() + it->value().size();
+        }
+        hist->add(elapsed_ns(t0));
+    }
+    delete it;
+}
+
+/* Runs one lookup model and prints throughput, IOPS, latency, CPU */
+static void run_lookup_model(DB *db, Statistics *stats, const char *label, int nthreads,
+                             bool multiget, uint64_t seed_base) {
+    std::vector<LatencyHistogram> hists(nthreads);
+    std::vector<std::thread> threads;
+    std::atomic<long long> errors(0);
+    long long per_thread = FLAGS.async_ops / nthreads;
+    long long remainder = FLAGS.async_ops % nthreads;
+    long long total = 0;
+
+    uint64_t misses_before = stats->getTickerCount(BLOCK_CACHE_DATA_MISS);
+    double cpu_start = get_cpu_time();
+    double start = get_time();
+
+    for (int t = 0; t < nthreads; t++) {
+        long long ops = per_thread + (t < remainder ? 1 : 0);
+        if (multiget) {
+            ops = (ops + FLAGS.multiget_batch - 1) / FLAGS.multiget_batch * FLAGS.multiget_batch;
+            threads.emplace_back(multiget_worker, db, ops, seed_base + t, &hists[t], &errors);
+        } else {
+            threads.emplace_back(get_worker, db, ops, seed_base + t, &hists[t], &errors);
+        }
+        total += ops;
+    }
+    for (auto &th : threads) th.join();
+
+    double elapsed = get_time() - start;
+    double cpu = get_cpu_time() - cpu_start;
+    uint64_t block_reads = stats->getTickerCount(BLOCK_CACHE_DATA_MISS) - misses_before;
+
+    LatencyHistogram merged;
+    for (const auto &h : hists) merged.merge(h);
+
+    print_result(label, elapsed, total);
+    record_errors(label, errors.load());
+    printf("  %-30s: %.0f data-block reads/sec\n", "IOPS", block_reads / elapsed);
+    print_latency(multiget ? "Latency per MultiGet" : "Latency per Get", merged);
+    printf("  %-30s: %.2f us (%.0f%% of %d cores)\n", "CPU per lookup",
+           1e6 * cpu / total, 100.0 * cpu / elapsed / std::thread::hardware_concurrency(),
+           (int)std::thread::hardware_concurrency());
+}
+
+static void bench_async_multiget(const Options &base_options) {
+    print_header("BENCHMARK 10: Async MultiGet vs Thread-per-Request");
+
+    Options options = base_options;
+    options.create_if_missing = false;
+    options.use_direct_reads = FLAGS.direct_reads;
+    options.statistics = CreateDBStatistics();
+
+    DB *db = NULL;
+    Status s = DB::Open(options, FLAGS.db, &db);
+    if (!s.ok()) {
+        fprintf(stderr, "  Failed to reopen %s: %s\n", FLAGS.db.c_str(), s.ToString().c_str());
+        return;
+    }
+
+    char size_buf[64];
+    format_memory((long)(get_int_property(db, "rocksdb.total-sst-files-size") / 1024),
+                  size_buf, sizeof(size_buf));
+    printf("  DB size %s vs 2 MB block cache, direct reads %s\n", size_buf,
+           FLAGS.direct_reads ? "on" : "off");
+    printf("  Async: %d threads x MultiGet(%d), sync: %d threads x Get\n\n",
+           FLAGS.async_threads, FLAGS.multiget_batch, FLAGS.sync_threads);
+
+    uint64_t seed = stream_seed(STREAM_READS) ^ 0xA5A5A5A5ULL;
+    run_lookup_model(db, options.statistics.get(), "Async MultiGet",
+                     FLAGS.async_threads, true, seed);
+    printf("\n");
+    run_lookup_model(db, options.statistics.get(), "Sync thread-per-request",
+                     FLAGS.sync_threads, false, seed + 1000);
+
+    // Iterator scans with and without async prefetching
+    const int scans = 2000, scan_len = 1000;
+    printf("\n");
+    for (int async_io = 0; async_io <= 1; async_io++) {
+        LatencyHistogram hist;
+        long long bytes = 0;
+        double start = get_time();
+        scan_worker(db, async_io, scans, scan_len, seed + 2000, &hist, &bytes);
+        double elapsed = get_time() - start;
+
+        const char *label = async_io ? "Scan (async_io)" : "Scan (sync)";
+        report_subsection(label);
+        printf("  %-30s: " COLOR_GREEN "%.1f MB/sec" COLOR_RESET " (%d scans of %d keys)\n",
+               label, bytes / (1024.0 * 1024.0) / elapsed, scans, scan_len);
+        print_latency("Latency per scan", hist);
+    }
+
+    delete db;
+}
+
+/* ==================== Auxiliary Databases ==================== */
+/* Formats the key of record i; lets the format benchmarks share loaders */
+typedef int (*KeyFormat)(char *buf, size_t size, long long i);
+
+/* Create a fresh DB at path and load num records through the WAL-less
+** write path, then flush and compact everything so that every table is
+** built with the options under test. Returns NULL on failure. */
+static DB *build_aux_db(const std::string &path, const Options &options,
+                        long long num, KeyFormat key_fn) {
+    DB *db = NULL;
+    char key[64], value[128];
+
+    DestroyDB(path, options);
+    Status s = DB::Open(options, path, &db);
+    if (!s.ok()) {
+        fprintf(stderr, "  Failed to open %s: %s\n", path.c_str(), s.ToString().c_str());
+        return NULL;
+    }
+
+    WriteOptions write_opts;
+    write_opts.disableWAL = true;
+    for (long long i = 0; i < num && s.ok(); ) {
+        WriteBatch batch;
+        for (int j = 0; j < BATCH_SIZE && i < num; j++, i++) {
+            int klen = key_fn(key, sizeof(key), i);
+            int vlen = fill_value(value, sizeof(value), i);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+        }
+        s = db->Write(write_opts, &batch);
+    }
+
+    if (s.ok()) {
+        FlushOptions flush_opts;
+        flush_opts.wait = true;
+        s = db->Flush(flush_opts);
+    }
+    if (s.ok()) {
+        CompactRangeOptions compact_opts;
+        compact_opts.bottommost_level_compaction = BottommostLevelCompaction::kForce;
+        s = db->CompactRange(compact_opts, NULL, NULL);
+    }
+    if (!s.ok()) {
+        fprintf(stderr, "  Failed to load %s: %s\n", path.c_str(), s.ToString().c_str());
+        delete db;
+        return NULL;
+    }
+    return db;
+}
+
+/* Random point lookups of records [0, num); returns elapsed seconds */
+static double measure_gets(DB *db, long long num, int reads, KeyFormat key_fn,
+                           uint64_t seed, LatencyHistogram *hist, long long *errors) {
+    BenchRandom rng(seed);
+    ReadOptions read_opts;
+    std::string value;
+    char key[64];
+
+    double start = get_time();
+    for (int i = 0; i < reads; i++) {
+        int klen = key_fn(key, sizeof(key), rng.uniform(num));
+
+        uint64_t t0 = now_ns();
+        Status s = db->Get(read_opts, Slice(key, klen), &value);
+        hist->add(elapsed_ns(t0));
+
+        if (read_failed(s)) (*errors)++;
+    }
+    return get_time() - start;
+}
+
+/* Table readers plus block cache, i.e. what the format keeps resident */
+static uint64_t table_memory_bytes(DB *db) {
+    return get_int_property(db, "rocksdb.estimate-table-readers-mem") +
+           get_int_property(db, "rocksdb.block-cache-usage");
+}
+
+/* ==================== BENCHMARK 11: Prefix Workload ==================== */
+#define TENANT_PREFIX_LEN 7  /* "t00042_" */
+
+/* Record i belongs to tenant i % prefix_tenants */
+static int tenant_key(char *buf, size_t size, long long i) {
+    return snprintf(buf, size, "t%05lld_key_%0*lld", i % FLAGS.prefix_tenants,
+                    FLAGS.key_width, i);
+}
+
+/* Seek to a random tenant's prefix and read all of its keys */
+static double measure_prefix_seeks(DB *db, int seeks, uint64_t seed,
+                                   LatencyHistogram *hist, long long *keys_read) {
+    BenchRandom rng(seed);
+    ReadOptions read_opts;
+    read_opts.prefix_same_as_start = true;
+    char prefix[16];
+
+    Iterator *it = db->NewIterator(read_opts);
+    double start = get_time();
+    for (int i = 0; i < seeks; i++) {
+        snprintf(prefix, sizeof(prefix), "t%05lld_", rng.uniform(FLAGS.prefix_tenants));
+
+        uint64_t t0 = now_ns();
+        for (it->Seek(Slice(prefix, TENANT_PREFIX_LEN)); it->Valid(); it->Next()) {
+            (*keys_read)++;
+        }
+        hist->add(elapsed_ns(t0));
+    }
+    double elapsed = get_time() - start;
+    delete it;
+    return elapsed;
+}
+
+static void configure_prefix_options(Options &options, const char *format) {
+    configure_small_db_options(options, false);
+    options.prefix_extractor.reset(NewFixedPrefixTransform(TENANT_PREFIX_LEN));
+    options.memtable_prefix_bloom_size_ratio = 0.1;
+
+    // Enough cache for the whole dataset when memory-resident
+    size_t cache_bytes = FLAGS.prefix_in_memory
+                             ? (size_t)std::max(64LL << 20, FLAGS.num * 256)
+                             : 2 * 1024 * 1024;
+
+    if (strcmp(format, "plain") == 0) {
+        PlainTableOptions plain_opts;
+        plain_opts.user_key_len = 0;  // kPlainTableVariableLength
+        plain_opts.bloom_bits_per_key = 10;
+        plain_opts.hash_table_ratio = 0.75;
+        plain_opts.index_sparseness = 16;
+        options.table_factory.reset(NewPlainTableFactory(plain_opts));
+        options.allow_mmap_reads = true;  // PlainTable requires mmap
+        return;
+    }
+
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewLRUCache(cache_bytes);
+    table_options.block_size = 4 * 1024;
+    table_options.filter_policy.reset(NewBloomFilterPolicy(10));
+    table_options.whole_key_filtering = true;
+    table_options.index_type = strcmp(format, "hash") == 0
+                                   ? BlockBasedTableOptions::kHashSearch
+                                   : BlockBasedTableOptions::kBinarySearch;
+    if (FLAGS.prefix_in_memory) {
+        table_options.cache_index_and_filter_blocks = true;
+        table_options.pin_l0_filter_and_index_blocks_in_cache = true;
+    }
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+}
+
+static void bench_prefix_workload(void) {
+    print_header("BENCHMARK 11: Prefix Workload (tenant-prefixed keys)");
+    printf("  %lld keys over %d tenants, prefix length %d, %s\n\n", FLAGS.num,
+           FLAGS.prefix_tenants, TENANT_PREFIX_LEN,
+           FLAGS.prefix_in_memory ? "memory-resident" : "2 MB block cache");
+
+    static const struct {
+        const char *format;
+        const char *label;
+    } formats[] = {
+        {"binary", "BlockBased (binary index)"},
+        {"hash", "BlockBased (hash index)"},
+        {"plain", "PlainTable (mmap)"},
+    };
+    const std::string path = FLAGS.db + "_prefix";
+    const int seeks = std::max(1, NUM_READS / 10);
+
+    for (const auto &f : formats) {
+        Options options;
+        configure_prefix_options(options, f.format);
+
+        DB *db = build_aux_db(path, options, FLAGS.num, tenant_key);
+        if (!db) continue;
+
+        if (FLAGS.prefix_in_memory) {
+            // Warm every block (or mmap page) before measuring
+            Iterator *it = db->NewIterator(ReadOptions());
+            for (it->SeekToFirst(); it->Valid(); it->Next()) {}
+            delete it;
+        }
+
+        LatencyHistogram get_hist, seek_hist;
+        long long errors = 0, keys_read = 0;
+        double get_elapsed = measure_gets(db, FLAGS.num, NUM_READS, tenant_key,
+                                          stream_seed(STREAM_READS), &get_hist, &errors);
+        double seek_elapsed = measure_prefix_seeks(db, seeks, stream_seed(STREAM_READS),
+                                                   &seek_hist, &keys_read);
+
+        printf("  " COLOR_YELLOW "%s" COLOR_RESET "\n", f.label);
+        report_subsection(f.label);
+        print_result("Get", get_elapsed, NUM_READS);
+        print_latency("Get latency", get_hist);
+        print_result("Prefix seek + scan", seek_elapsed, seeks);
+        print_latency("Prefix seek latency", seek_hist);
+        printf("  %-30s: %.1f keys per prefix\n", "Prefix scan length",
+               (double)keys_read / seeks);
+        record_errors(f.label, errors);
+
+        char mem_buf[64];
+        format_memory((long)(table_memory_bytes(db) / 1024), mem_buf, sizeof(mem_buf));
+        printf("  %-30s: %s\n\n", "Table + cache memory", mem_buf);
+
+        delete db;
+        DestroyDB(path, options);
+    }
+}
+
+/* ==================== BENCHMARK 12: Read-Only Table Formats ==================== */
+/* CuckooTable needs fixed-length keys and values within a file and has
+** no sorted order of its own, which suits immutable lookup tables. Each
+** format gets the same freshly loaded dataset (no updates or deletes),
+** is reopened with OpenForReadOnly, and probed with random reads plus
+** exists checks of which half target absent keys. */
+static void bench_readonly_formats(void) {
+    print_header("BENCHMARK 12: Read-Only Formats (Cuckoo vs BlockBased vs PlainTable)");
+    printf("  %lld keys per format, opened read-only\n\n", FLAGS.num);
+
+    static const char *formats[] = {"BlockBased", "PlainTable", "CuckooTable"};
+    const std::string path = FLAGS.db + "_readonly";
+
+    for (const char *format : formats) {
+        Options options;
+        configure_small_db_options(options, false);
+
+        if (strcmp(format, "PlainTable") == 0) {
+            options.table_factory.reset(NewPlainTableFactory(PlainTableOptions()));
+            options.allow_mmap_reads = true;
+        } else if (strcmp(format, "CuckooTable") == 0) {
+            CuckooTableOptions cuckoo_opts;
+            cuckoo_opts.hash_table_ratio = 0.9;
+            options.table_factory.reset(NewCuckooTableFactory(cuckoo_opts));
+            options.allow_mmap_reads = true;  // CuckooTable reads through mmap
+        }
+
+        DB *db = build_aux_db(path, options, FLAGS.num, fill_key);
+        if (!db) continue;
+        delete db;
+
+        long rss_before = get_memory_usage();
+        double open_start = get_time();
+        Status s = DB::OpenForReadOnly(options, path, &db);
+        double open_elapsed = get_time() - open_start;
+        if (!s.ok()) {
+            fprintf(stderr, "  Failed to open %s read-only: %s\n", format, s.ToString().c_str());
+            DestroyDB(path, options);
+            continue;
+        }
+
+        LatencyHistogram read_hist, exists_hist;
+        long long errors = 0;
+        double read_elapsed = measure_gets(db, FLAGS.num, NUM_READS, fill_key,
+                                           stream_seed(STREAM_READS), &read_hist, &errors);
+        double exists_elapsed = measure_gets(db, 2 * FLAGS.num, NUM_READS, fill_key,
+                                             stream_seed(STREAM_EXISTS), &exists_hist, &errors);
+
+        printf("  " COLOR_YELLOW "%s" COLOR_RESET " (opened in %.3f seconds)\n",
+               format, open_elapsed);
+        report_subsection(format);
+        print_result("Random reads", read_elapsed, NUM_READS);
+        print_latency("Read latency", read_hist);
+        print_result("Exists checks (50% absent)", exists_elapsed, NUM_READS);
+        print_latency("Exists latency", exists_hist);
+        record_errors(format, errors);
+
+        char mem_buf[64];
+        format_memory((long)(table_memory_bytes(db) / 1024), mem_buf, sizeof(mem_buf));
+        printf("  %-30s: %s\n", "Table + cache memory", mem_buf);
+        format_memory(get_memory_usage() - rss_before, mem_buf, sizeof(mem_buf));
+        printf("  %-30s: %s\n\n", "RSS growth (open + reads)", mem_buf);
+
+        delete db;
+        DestroyDB(path, options);
+    }
+}
+
+/* ==================== BENCHMARK 13: Read-Only and Secondary Instances ==================== */
+/* The primary stamps a heartbeat key with get_time() at each commit; a
+** replica's staleness is how old the heartbeat it sees is. get_time()
+** is CLOCK_MONOTONIC seconds, which only compare between processes on
+** the same host, so primary and replicas must run on one machine. */
+#define HEARTBEAT_KEY "__replica_heartbeat"
+
+static double read_heartbeat_age(DB *db) {
+    std::string value;
+    if (!db->Get(ReadOptions(), HEARTBEAT_KEY, &value).ok()) return -1;
+    return get_time() - atof(value.c_str());
+}
+
+/* Entry point of the re-executed primary process */
+static int run_replica_primary(void) {
+    Options options;
+    configure_small_db_options(options, false);
+    options.create_if_missing = false;
+
+    DB *db = NULL;
+    Status s = DB::Open(options, FLAGS.db, &db);
+    if (!s.ok()) {
+        fprintf(stderr, "  Primary failed to open %s: %s\n", FLAGS.db.c_str(), s.ToString().c_str());
+        return 1;
+    }
+
+    BenchRandom rng(stream_seed(STREAM_OVERWRITE));
+    WriteOptions write_opts;
+    char key[32], value[128], stamp[32];
+    long long writes = 0;
+    double start = get_time();
+
+    while (get_time() - start < FLAGS.replica_duration_sec) {
+        WriteBatch batch;
+        for (int j = 0; j < 100; j++, writes++) {
+            long long idx = rng.uniform(FLAGS.num);
+            int klen = fill_key(key, sizeof(key), idx);
+            int vlen = format_value(value, sizeof(value), idx,
+                                    VERSION_OVERWRITE_BASE + (uint32_t)writes);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+        }
+        int slen = snprintf(stamp, sizeof(stamp), "%.6f", get_time());
+        batch.Put(HEARTBEAT_KEY, Slice(stamp, slen));
+        if (!db->Write(write_opts, &batch).ok()) break;
+    }
+
+    double elapsed = get_time() - start;
+    delete db;
+    printf("  %-30s: %.0f writes/sec for %.1f seconds\n", "Primary (other process)",
+           writes / elapsed, elapsed);
+    return 0;
+}
+
+static pid_t spawn_replica_primary(const std::string &path) {
+    // Re-exec rather than continuing in the fork: RocksDB's background
+    // thread pools do not survive fork(). Arguments are built first,
+    // because another thread may hold the allocator lock at fork time
+    // and the child must not allocate; it only calls execl and _exit.
+    std::string db_arg = "--db=" + path;
+    std::string num_arg = "--num=" + std::to_string(FLAGS.num);
+    std::string dur_arg = "--replica_duration_sec=" + std::to_string(FLAGS.replica_duration_sec);
+    std::string seed_arg = "--seed=" + std::to_string(FLAGS.seed);
+    std::string width_arg = "--key_width=" + std::to_string(FLAGS.key_width);
+
+    pid_t pid = fork();
+    if (pid != 0) return pid;
+
+    execl("/proc/self/exe", "rocksdb_benchmark", "--replica_primary=1", db_arg.c_str(),
+          num_arg.c_str(), dur_arg.c_str(), seed_arg.c_str(), width_arg.c_str(), (char *)NULL);
+    _exit(127);
+}
+
+static void bench_replicas(void) {
+    print_header("BENCHMARK 13: Read-Only and Secondary Instances");
+
+    const std::string path = FLAGS.db + "_primary";
+    const std::string secondary_path = FLAGS.db + "_secondary";
+    Options options;
+    configure_small_db_options(options, false);
+
+    DB *db = build_aux_db(path, options, FLAGS.num, fill_key);
+    if (!db) return;
+    delete db;
+
+    printf("  Primary writes for %d seconds in a separate process...\n\n",
+           FLAGS.replica_duration_sec);
+    pid_t primary = spawn_replica_primary(path);
+    if (primary < 0) {
+        perror("fork");
+        DestroyDB(path, options);
+        return;
+    }
+
+    // Wait for the primary's first heartbeat so every measurement
+    // below happens while it is writing
+    double wait_start = get_time();
+    while (get_time() - wait_start < 30) {
+        // The child cannot report a failed exec itself; its exit code can
+        int wstatus;
+        if (waitpid(primary, &wstatus, WNOHANG) == primary) {
+            fprintf(stderr, "  Replica primary exited early (exit code %d)\n",
+                    WIFEXITED(wstatus) ? WEXITSTATUS(wstatus) : -1);
+            DestroyDB(path, options);
+            return;
+        }
+        if (DB::OpenForReadOnly(options, path, &db).ok()) {
+            double age = read_heartbeat_age(db);
+            delete db;
+            if (age >= 0) break;
+        }
+        usleep(50 * 1000);
+    }
+
+    /* Read-only instance: open cost, read throughput, staleness at open */
+    double open_start = get_time();
+    Status s = DB::OpenForReadOnly(options, path, &db);
+    double open_elapsed = get_time() - open_start;
+    if (s.ok()) {
+        double age = read_heartbeat_age(db);
+        LatencyHistogram hist;
+        long long errors = 0;
+        double elapsed = measure_gets(db, FLAGS.num, NUM_READS, fill_key,
+                                      stream_seed(STREAM_READS), &hist, &errors);
+
+        printf("  " COLOR_YELLOW "OpenForReadOnly" COLOR_RESET "\n");
+        report_subsection("OpenForReadOnly");
+        printf("  %-30s: %.3f seconds\n", "Open time", open_elapsed);
+        print_result("Get", elapsed, NUM_READS);
+        print_latency("Get latency", hist);
+        printf("  %-30s: %.3f seconds (fixed until reopened)\n\n", "Staleness at open", age);
+        record_errors("Read-only instance", errors);
+        delete db;
+    } else {
+        fprintf(stderr, "  OpenForReadOnly failed: %s\n", s.ToString().c_str());
+    }
+
+    /* Secondary instance: catch up periodically while serving reads */
+    Options secondary_options = options;
+    secondary_options.max_open_files = -1;  // Required for secondaries
+    open_start = get_time();
+    s = DB::OpenAsSecondary(secondary_options, path, secondary_path, &db);
+    open_elapsed = get_time() - open_start;
+    if (s.ok()) {
+        LatencyHistogram catchup_hist, staleness_hist, get_hist;
+        BenchRandom rng(stream_seed(STREAM_READS) + 1);
+        ReadOptions read_opts;
+        std::string value;
+        char key[32];
+        long long reads = 0, errors = 0;
+        double start = get_time(), next_catchup = start;
+
+        while (waitpid(primary, NULL, WNOHANG) == 0) {
+            double now = get_time();
+            if (now >= next_catchup) {
+                uint64_t t0 = now_ns();
+                Status cs = db->TryCatchUpWithPrimary();
+                catchup_hist.add(elapsed_ns(t0));
+                if (!cs.ok()) errors++;
+
+                double age = read_heartbeat_age(db);
+                if (age >= 0) staleness_hist.add((uint64_t)(age * 1e9));
+                next_catchup = now + FLAGS.replica_catchup_ms / 1000.0;
+            }
+
+            int klen = fill_key(key, sizeof(key), rng.uniform(FLAGS.num));
+            uint64_t t0 = now_ns();
+            Status gs = db->Get(read_opts, Slice(key, klen), &value);
+            get_hist.add(elapsed_ns(t0));
+            if (read_failed(gs)) errors++;
+            reads++;
+        }
+        primary = -1;  // Reaped by waitpid above
+        double elapsed = get_time() - start;
+
+        printf("  " COLOR_YELLOW "OpenAsSecondary" COLOR_RESET " (catch up every %d ms)\n",
+               FLAGS.replica_catchup_ms);
+        report_subsection("OpenAsSecondary");
+        printf("  %-30s: %.3f seconds\n", "Open time", open_elapsed);
+        print_result("Get", elapsed, reads);
+        print_latency("Get latency", get_hist);
+        print_latency("TryCatchUpWithPrimary", catchup_hist);
+        print_latency("Staleness after catch-up", staleness_hist);
+        record_errors("Secondary instance", errors);
+        delete db;
+    } else {
+        fprintf(stderr, "  OpenAsSecondary failed: %s\n", s.ToString().c_str());
+    }
+
+    if (primary > 0) waitpid(primary, NULL, 0);
+
+    std::error_code ec;
+    std::filesystem::remove_all(secondary_path, ec);
+    DestroyDB(path, options);
+}
+
+/* ==================== BENCHMARK 14: Block Format Sweep ==================== */
+struct SweepResult {
+    int block_size;
+    int restart;
+    int index_restart;
+    std::string data_index;
+    double get_avg_us;
+    double get_p99_us;
+    double scan_mb_sec;
+    uint64_t index_bytes;
+    double cache_hit_pct;
+};
+
+static bool run_block_sweep_point(int block_size, int restart, int index_restart,
+                                  const std::string &data_index, SweepResult *r) {
+    const std::string path = FLAGS.db + "_sweep";
+    Options options;
+    configure_small_db_options(options, false);
+
+    BlockBasedTableOptions table_options;
+    table_options.block_cache = NewLRUCache(2 * 1024 * 1024);
+    table_options.block_size = block_size;
+    table_options.block_restart_interval = restart;
+    table_options.index_block_restart_interval = index_restart;
+    table_options.filter_policy = nullptr;
+    if (data_index == "hash") {
+        table_options.data_block_index_type = BlockBasedTableOptions::kDataBlockBinaryAndHash;
+        table_options.data_block_hash_table_util_ratio = 0.75;
+    } else {
+        table_options.data_block_index_type = BlockBasedTableOptions::kDataBlockBinarySearch;
+    }
+    options.table_factory.reset(NewBlockBasedTableFactory(table_options));
+
+    DB *db = build_aux_db(path, options, FLAGS.num, fill_key);
+    if (!db) return false;
+
+    Statistics *stats = options.statistics.get();
+    uint64_t hits = stats->getTickerCount(BLOCK_CACHE_HIT);
+    uint64_t misses = stats->getTickerCount(BLOCK_CACHE_MISS);
+
+    LatencyHistogram hist;
+    long long errors = 0;
+    measure_gets(db, FLAGS.num, NUM_READS, fill_key, stream_seed(STREAM_READS), &hist, &errors);
+    record_errors("Block sweep", errors);
+
+    hits = stats->getTickerCount(BLOCK_CACHE_HIT) - hits;
+    misses = stats->getTickerCount(BLOCK_CACHE_MISS) - misses;
+
+    long long bytes = 0;
+    double start = get_time();
+    Iterator *it = db->NewIterator(ReadOptions());
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        bytes += it->key().size() + it->value().size();
+    }
+    delete it;
+    double scan_elapsed = get_time() - start;
+
+    r->block_size = block_size;
+    r->restart = restart;
+    r->index_restart = index_restart;
+    r->data_index = data_index;
+    r->get_avg_us = hist.total ? hist.sum / 1000.0 / hist.total : 0;
+    r->get_p99_us = hist.percentile(99) / 1000.0;
+    r->scan_mb_sec = bytes / (1024.0 * 1024.0) / scan_elapsed;
+    r->index_bytes = get_int_property(db, "rocksdb.estimate-table-readers-mem");
+    r->cache_hit_pct = hits + misses ? 100.0 * hits / (hits + misses) : 0;
+
+    delete db;
+    DestroyDB(path, options);
+    return true;
+}
+
+static void bench_block_sweep(void) {
+    print_header("BENCHMARK 14: Block Size and Restart Interval Sweep");
+
+    size_t points = FLAGS.sweep_block_sizes.size() * FLAGS.sweep_restart_intervals.size() *
+                    FLAGS.sweep_index_restart_intervals.size() * FLAGS.sweep_data_index.size();
+    printf("  %zu combinations, %lld keys each, 2 MB block cache\n\n", points, FLAGS.num);
+
+    std::vector<SweepResult> results;
+    for (int block_size : FLAGS.sweep_block_sizes) {
+        for (int restart : FLAGS.sweep_restart_intervals) {
+            for (int index_restart : FLAGS.sweep_index_restart_intervals) {
+                for (const auto &data_index : FLAGS.sweep_data_index) {
+                    SweepResult r;
+                    printf("  block=%d restart=%d index_restart=%d data_index=%s...\n",
+                           block_size, restart, index_restart, data_index.c_str());
+                    fflush(stdout);
+                    if (run_block_sweep_point(block_size, restart, index_restart,
+                                              data_index, &r)) {
+                        results.push_back(r);
+                    }
+                }
+            }
+        }
+    }
+
+    printf("\n  %7s %7s %9s %6s | %10s %10s %10s %10s %7s\n", "block", "restart",
+           "idx_rst", "dbi", "get avg", "get p99", "scan MB/s", "index KB", "hit %");
+    for (const auto &r : results) {
+        printf("  %7d %7d %9d %6s | %8.2fus %8.2fus %10.1f %10.1f %6.1f%%\n",
+               r.block_size, r.restart, r.index_restart, r.data_index.c_str(),
+               r.get_avg_us, r.get_p99_us, r.scan_mb_sec, r.index_bytes / 1024.0,
+               r.cache_hit_pct);
+
+        char point[96];
+        snprintf(point, sizeof(point), "block=%d restart=%d index_restart=%d data_index=%s",
+                 r.block_size, r.restart, r.index_restart, r.data_index.c_str());
+        report_subsection(point);
+        report_metric("Get avg", "us", r.get_avg_us);
+        report_metric("Get p99", "us", r.get_p99_us);
+        report_metric("Scan", "MB/sec", r.scan_mb_sec);
+        report_metric("Index", "KB", r.index_bytes / 1024.0);
+        report_metric("Block cache hit", "%", r.cache_hit_pct);
+    }
+}
+
+/* ==================== BENCHMARK 15: Tiered Placement ==================== */
+/* Per-tier read counters filled in by TieredFileSystem */
+struct TierStats {
+    std::atomic<uint64_t> reads[2];
+    std::atomic<uint64_t> bytes[2];
+
+    void reset() {
+        for (int t = 0; t < 2; t++) {
+            reads[t].store(0);
+            bytes[t].store(0);
+        }
+    }
+};
+
+class TierCountingFile : public FSRandomAccessFileOwnerWrapper {
+public:
+    TierCountingFile(std::unique_ptr<FSRandomAccessFile> &&file, TierStats *stats, int tier,
+                     int latency_us)
+        : FSRandomAccessFileOwnerWrapper(std::move(file)), stats_(stats), tier_(tier),
+          latency_us_(latency_us) {}
+
+    IOStatus Read(uint64_t offset, size_t n, const IOOptions &options, Slice *result,
+                  char *scratch, IODebugContext *dbg) const override {
+        stats_->reads[tier_].fetch_add(1, std::memory_order_relaxed);
+        stats_->bytes[tier_].fetch_add(n, std::memory_order_relaxed);
+        if (latency_us_ > 0) usleep(latency_us_);
+        return FSRandomAccessFileOwnerWrapper::Read(offset, n, options, result, scratch, dbg);
+    }
+
+private:
+    TierStats *stats_;
+    int tier_;
+    int latency_us_;
+};
+
+/* Attributes every random-access read to the fast (0) or slow (1) tier
+** by path, delaying slow-tier reads by slow_read_latency_us */
+class TieredFileSystem : public FileSystemWrapper {
+public:
+    TieredFileSystem(const std::shared_ptr<FileSystem> &base, const std::string &slow_dir,
+                     TierStats *stats)
+        : FileSystemWrapper(base), slow_dir_(slow_dir), stats_(stats) {
+        if (slow_dir_.empty() || slow_dir_.back() != '/') slow_dir_ += '/';
+    }
+
+    const char *Name() const override { return "TieredFileSystem"; }
+
+    IOStatus NewRandomAccessFile(const std::string &fname, const FileOptions &opts,
+                                 std::unique_ptr<FSRandomAccessFile> *result,
+                                 IODebugContext *dbg) override {
+        IOStatus s = FileSystemWrapper::NewRandomAccessFile(fname, opts, result, dbg);
+        if (s.ok()) {
+            int tier = fname.compare(0, slow_dir_.size(), slow_dir_) == 0 ? 1 : 0;
+            result->reset(new TierCountingFile(std::move(*result), stats_, tier,
+                                               tier ? FLAGS.slow_read_latency_us : 0));
+        }
+        return s;
+    }
+
+private:
+    std::string slow_dir_;
+    TierStats *stats_;
+};
+
+/* SST file count and bytes currently in dir */
+static void tier_usage(const std::string &dir, int *files, uint64_t *bytes) {
+    std::error_code ec;
+    *files = 0;
+    *bytes = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(dir, ec)) {
+        if (entry.path().extension() == ".sst") {
+            (*files)++;
+            *bytes += entry.file_size(ec);
+        }
+    }
+}
+
+static void bench_tiered_placement(void) {
+    print_header("BENCHMARK 15: Tiered Placement (db_paths)");
+
+    TierStats tier_stats;
+    tier_stats.reset();
+    std::shared_ptr<FileSystem> fs(
+        new TieredFileSystem(FileSystem::Default(), FLAGS.slow_path, &tier_stats));
+    std::unique_ptr<Env> env = NewCompositeEnv(fs);
+
+    Options options;
+    configure_small_db_options(options, false);
+    options.env = env.get();
+    options.db_paths.emplace_back(FLAGS.fast_path, (uint64_t)FLAGS.fast_target_mb << 20);
+    options.db_paths.emplace_back(FLAGS.slow_path, UINT64_MAX);
+    if (FLAGS.cold_last_level) {
+        options.last_level_temperature = Temperature::kCold;
+    }
+
+    printf("  Fast tier: %s (target %d MB)\n", FLAGS.fast_path.c_str(), FLAGS.fast_target_mb);
+    printf("  Slow tier: %s (+%d us per read)%s\n", FLAGS.slow_path.c_str(),
+           FLAGS.slow_read_latency_us, FLAGS.cold_last_level ? ", last level kCold" : "");
+    printf("  %d aging rounds of %lld overwrites each\n\n", FLAGS.tiered_rounds, FLAGS.num / 2);
+
+    const std::string path = FLAGS.db + "_tiered";
+    DB *db = build_aux_db(path, options, FLAGS.num, fill_key);
+    if (!db) return;
+
+    printf("  %5s | %6s %9s | %6s %9s | %7s %8s | %9s %9s\n", "round", "fast", "fast MB",
+           "slow", "slow MB", "fast rd", "slow rd", "get avg", "get p99");
+
+    BenchRandom rng(stream_seed(STREAM_OVERWRITE));
+    long long errors = 0;
+    for (int round = 0; round <= FLAGS.tiered_rounds; round++) {
+        if (round > 0) {
+            // Age the data: overwrite half the keys, then let compaction
+            // push the older versions down toward the slow tier
+            WriteOptions write_opts;
+            write_opts.disableWAL = true;
+            char key[32], value[128];
+            for (long long i = 0; i < FLAGS.num / 2; ) {
+                WriteBatch batch;
+                for (int j = 0; j < BATCH_SIZE && i < FLAGS.num / 2; j++, i++) {
+                    long long idx = rng.uniform(FLAGS.num);
+                    int klen = fill_key(key, sizeof(key), idx);
+                    int vlen = format_value(value, sizeof(value), idx,
+                                            VERSION_OVERWRITE_BASE + (uint32_t)i);
+                    batch.Put(Slice(key, klen), Slice(value, vlen));
+                }
+                if (!db->Write(write_opts, &batch).ok()) errors++;
+            }
+            FlushOptions flush_opts;
+            flush_opts.wait = true;
+            db->Flush(flush_opts);
+            wait_for_quiesce(db);
+        }
+
+        tier_stats.reset();
+        LatencyHistogram hist;
+        measure_gets(db, FLAGS.num, NUM_READS, fill_key, stream_seed(STREAM_READS) + round,
+                     &hist, &errors);
+
+        int fast_files, slow_files;
+        uint64_t fast_bytes, slow_bytes;
+        tier_usage(FLAGS.fast_path, &fast_files, &fast_bytes);
+        tier_usage(FLAGS.slow_path, &slow_files, &slow_bytes);
+        uint64_t fast_reads = tier_stats.reads[0], slow_reads = tier_stats.reads[1];
+        uint64_t all_reads = std::max<uint64_t>(1, fast_reads + slow_reads);
+
+        printf("  %5d | %6d %9.1f | %6d %9.1f | %6.1f%% %7.1f%% | %7.2fus %7.2fus\n", round,
+               fast_files, fast_bytes / (1024.0 * 1024.0), slow_files,
+               slow_bytes / (1024.0 * 1024.0), 100.0 * fast_reads / all_reads,
+               100.0 * slow_reads / all_reads,
+               hist.total ? hist.sum / 1000.0 / hist.total : 0.0, hist.percentile(99) / 1000.0);
+
+        report_subsection("round " + std::to_string(round));
+        report_metric("Fast tier SST", "MB", fast_bytes / (1024.0 * 1024.0));
+        report_metric("Slow tier SST", "MB", slow_bytes / (1024.0 * 1024.0));
+        report_metric("Reads from fast tier", "%", 100.0 * fast_reads / all_reads);
+        report_metric("Get avg", "us", hist.total ? hist.sum / 1000.0 / hist.total : 0.0);
+        report_metric("Get p99", "us", hist.percentile(99) / 1000.0);
+    }
+    record_errors("Tiered placement", errors);
+
+    delete db;
+    DestroyDB(path, options);
+}
+
+/* ==================== BENCHMARK 16: Periodic and TTL Compaction ==================== */
+/* Counts finished compactions by reason so intervals can be tagged */
+class CompactionReasonCounter : public EventListener {
+public:
+    std::atomic<uint64_t> periodic{0};
+    std::atomic<uint64_t> ttl{0};
+    std::atomic<uint64_t> other{0};
+    std::atomic<uint64_t> periodic_ttl_bytes{0};
+
+    void OnCompactionCompleted(DB *, const CompactionJobInfo &ci) override {
+        if (ci.compaction_reason == CompactionReason::kPeriodicCompaction) {
+            periodic++;
+        } else if (ci.compaction_reason == CompactionReason::kTtl) {
+            ttl++;
+        } else {
+            other++;
+            return;
+        }
+        periodic_ttl_bytes += ci.stats.total_input_bytes + ci.stats.total_output_bytes;
+    }
+};
+
+static void bench_periodic_compaction(void) {
+    print_header("BENCHMARK 16: Periodic and TTL Compaction Impact");
+    printf("  periodic_compaction_seconds=%d, ttl=%d, running for %d seconds\n\n",
+           FLAGS.periodic_compaction_sec, FLAGS.ttl_sec, FLAGS.periodic_duration_sec);
+
+    auto counter = std::make_shared<CompactionReasonCounter>();
+    Options options;
+    configure_small_db_options(options, false);
+    options.periodic_compaction_seconds = FLAGS.periodic_compaction_sec;
+    options.ttl = FLAGS.ttl_sec;
+    options.listeners.push_back(counter);
+
+    const std::string path = FLAGS.db + "_periodic";
+    DB *db = build_aux_db(path, options, FLAGS.num, fill_key);
+    if (!db) return;
+
+    Statistics *stats = options.statistics.get();
+    BenchRandom rng(stream_seed(STREAM_MIXED));
+    ReadOptions read_opts;
     WriteOptions write_opts;
-    write_opts.sync = true;  // Match SNKV's per-commit fsync
+    std::string value;
+    char key[32], new_value[128];
+    long long errors = 0, writes = 0;
 
-    start = get_time();
+    // Foreground p99 split by whether the interval saw periodic/TTL work
+    LatencyHistogram storm_hist, quiet_hist, interval_hist;
+    long long interval_ops = 0;
+    uint64_t last_periodic = 0, last_ttl = 0;
+    uint64_t last_read = stats->getTickerCount(COMPACT_READ_BYTES);
+    uint64_t last_write = stats->getTickerCount(COMPACT_WRITE_BYTES);
 
-    for (i = 0; i < NUM_RECORDS; ) {
-        WriteBatch batch;
+    printf("  %7s %10s %9s %9s %10s %10s %5s %5s\n", "elapsed", "ops/sec", "avg us",
+           "p99 us", "cmp rd MB", "cmp wr MB", "per", "ttl");
 
-        for (int j = 0; j < BATCH_SIZE && i < NUM_RECORDS; j++, i++) {
-            snprintf(key, sizeof(key), "key_%08d", i);
-            snprintf(value, sizeof(value),
-                     "value_%08d_with_some_additional_data_to_make_it_realistic", i);
+    double start = get_time(), interval_start = start;
+    while (get_time() - start < FLAGS.periodic_duration_sec) {
+        long long idx = rng.uniform(FLAGS.num);
+        int klen = fill_key(key, sizeof(key), idx);
 
-            batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
+        uint64_t t0 = now_ns();
+        if (rng.uniform(100) < 95) {
+            if (read_failed(db->Get(read_opts, Slice(key, klen), &value))) errors++;
+        } else {
+            // A trickle of writes keeps flushes, and with them compaction
+            // picking, going as in production
+            int vlen = format_value(new_value, sizeof(new_value), idx,
+                                    VERSION_OVERWRITE_BASE + (uint32_t)writes++);
+            if (!db->Put(write_opts, Slice(key, klen), Slice(new_value, vlen)).ok()) errors++;
         }
+        interval_hist.add(elapsed_ns(t0));
+        interval_ops++;
+
+        double now = get_time();
+        if (now - interval_start < FLAGS.periodic_report_sec) continue;
 
-        db->Write(write_opts, &batch);
+        uint64_t periodic = counter->periodic, ttl = counter->ttl;
+        uint64_t rd = stats->getTickerCount(COMPACT_READ_BYTES);
+        uint64_t wr = stats->getTickerCount(COMPACT_WRITE_BYTES);
+        bool storm = periodic != last_periodic || ttl != last_ttl ||
+                     get_int_property(db, "rocksdb.num-running-compactions") > 0;
+
+        printf("  %6.0fs %10.0f %9.2f %9.2f %10.1f %10.1f %5llu %5llu%s\n", now - start,
+               interval_ops / (now - interval_start),
+               interval_hist.sum / 1000.0 / interval_hist.total,
+               interval_hist.percentile(99) / 1000.0, (rd - last_read) / (1024.0 * 1024.0),
+               (wr - last_write) / (1024.0 * 1024.0),
+               (unsigned long long)(periodic - last_periodic),
+               (unsigned long long)(ttl - last_ttl),
+               periodic != last_periodic || ttl != last_ttl ? "  <-- periodic/ttl" : "");
+
+        (storm ? storm_hist : quiet_hist).merge(interval_hist);
+        interval_hist = LatencyHistogram();
+        interval_ops = 0;
+        interval_start = now;
+        last_periodic = periodic;
+        last_ttl = ttl;
+        last_read = rd;
+        last_write = wr;
     }
 
-    end = get_time();
+    printf("\n");
+    printf("  %-30s: %llu periodic, %llu ttl, %llu other\n", "Compactions",
+           (unsigned long long)counter->periodic.load(), (unsigned long long)counter->ttl.load(),
+           (unsigned long long)counter->other.load());
+    printf("  %-30s: %.1f MB\n", "Periodic/TTL compaction I/O",
+           counter->periodic_ttl_bytes / (1024.0 * 1024.0));
+    print_latency("Latency (compacting)", storm_hist);
+    print_latency("Latency (quiet)", quiet_hist);
+    record_errors("Periodic compaction", errors);
 
-    print_result("Sequential writes", end - start, NUM_RECORDS);
+    delete db;
+    DestroyDB(path, options);
 }
 
-/* ==================== BENCHMARK 2: Random Reads ==================== */
-static void bench_random_reads(DB *db) {
-    print_header("BENCHMARK 2: Random Reads");
-    printf("  Reading %d random records...\n\n", NUM_READS);
+/* ==================== BENCHMARK 17: Manual CompactRange ==================== */
+static BottommostLevelCompaction bottommost_option(const std::string &name) {
+    if (name == "skip") return BottommostLevelCompaction::kSkip;
+    if (name == "force") return BottommostLevelCompaction::kForce;
+    if (name == "force_optimized") return BottommostLevelCompaction::kForceOptimized;
+    return BottommostLevelCompaction::kIfHaveCompactionFilter;
+}
 
-    char key[32];
-    std::string value;
-    int i;
-    double start, end;
+/* One phase of one run, kept for the side-by-side summary */
+struct CompactPhaseResult {
+    double seconds = 0;
+    double read_avg_after_us = 0;
+    double read_p99_after_us = 0;
+};
 
-    start = get_time();
+static const char *const COMPACT_PHASES[2] = {
+    "After random-order load", "After overwriting half the keys",
+};
 
-    ReadOptions read_opts;
-    for (i = 0; i < NUM_READS; i++) {
-        int idx = rand() % NUM_RECORDS;
-        snprintf(key, sizeof(key), "key_%08d", idx);
+/* Reads, full CompactRange, reads again; prints one phase's report */
+static void compact_range_phase(DB *db, const Options &options, bool exclusive, int phase,
+                                uint64_t read_seed, CompactPhaseResult *r, long long *errors) {
+    Statistics *stats = options.statistics.get();
+    LatencyHistogram before, after;
+    const char *mode = exclusive ? "exclusive" : "non-exclusive";
 
-        db->Get(read_opts, Slice(key, strlen(key)), &value);
-    }
+    printf("  " COLOR_YELLOW "%s (%s)" COLOR_RESET "\n", COMPACT_PHASES[phase], mode);
+    report_subsection(std::string(mode) + " / " + COMPACT_PHASES[phase]);
+    printf("  %-30s: %s, %.1f MB\n", "Shape before", level_shape(db, options.num_levels).c_str(),
+           get_int_property(db, "rocksdb.total-sst-files-size") / (1024.0 * 1024.0));
+    measure_gets(db, FLAGS.num, NUM_READS, fill_key, read_seed, &before, errors);
 
-    end = get_time();
+    CompactRangeOptions compact_opts;
+    compact_opts.exclusive_manual_compaction = exclusive;
+    compact_opts.bottommost_level_compaction = bottommost_option(FLAGS.compact_bottommost);
+
+    uint64_t rd = stats->getTickerCount(COMPACT_READ_BYTES);
+    uint64_t wr = stats->getTickerCount(COMPACT_WRITE_BYTES);
+    double start = get_time();
+    Status s = db->CompactRange(compact_opts, NULL, NULL);
+    double elapsed = get_time() - start;
+    if (!s.ok()) (*errors)++;
+    rd = stats->getTickerCount(COMPACT_READ_BYTES) - rd;
+    wr = stats->getTickerCount(COMPACT_WRITE_BYTES) - wr;
+
+    measure_gets(db, FLAGS.num, NUM_READS, fill_key, read_seed, &after, errors);
 
-    print_result("Random reads", end - start, NUM_READS);
+    printf("  %-30s: " COLOR_GREEN "%.2f seconds" COLOR_RESET
+           " (%.1f MB read, %.1f MB written)\n", "CompactRange", elapsed,
+           rd / (1024.0 * 1024.0), wr / (1024.0 * 1024.0));
+    report_metric("CompactRange", "sec", elapsed);
+    printf("  %-30s: %s, %.1f MB\n", "Shape after", level_shape(db, options.num_levels).c_str(),
+           get_int_property(db, "rocksdb.total-sst-files-size") / (1024.0 * 1024.0));
+    print_latency("Read latency before", before);
+    print_latency("Read latency after", after);
+    if (before.total && after.total) {
+        double b = (double)before.sum / before.total, a = (double)after.sum / after.total;
+        printf("  %-30s: %+.1f%% avg, %+.1f%% p99\n", "Change after compaction",
+               100.0 * (a - b) / b,
+               100.0 * ((double)after.percentile(99) - before.percentile(99)) /
+                   std::max<uint64_t>(1, before.percentile(99)));
+        r->read_avg_after_us = a / 1000.0;
+        r->read_p99_after_us = after.percentile(99) / 1000.0;
+    }
+    printf("\n");
+    r->seconds = elapsed;
 }
 
-/* ==================== BENCHMARK 3: Sequential Scan ==================== */
-static void bench_sequential_scan(DB *db) {
-    print_header("BENCHMARK 3: Sequential Scan");
-    printf("  Scanning all records...\n\n");
+/* Load, compact, overwrite, compact on a fresh scratch DB. The streams
+** are seeded, so every run sees the same data and the same reads. */
+static void compact_range_run(bool exclusive, CompactPhaseResult results[2]) {
+    Options options;
+    configure_small_db_options(options, false);
+    const std::string path = FLAGS.db + "_compact";
 
-    int count = 0;
-    double start, end;
+    DestroyDB(path, options);
+    DB *db = NULL;
+    Status s = DB::Open(options, path, &db);
+    if (!s.ok()) {
+        fprintf(stderr, "  Failed to open %s: %s\n", path.c_str(), s.ToString().c_str());
+        return;
+    }
 
-    start = get_time();
+    // Random-order load leaves overlapping files and real compaction
+    // debt, unlike a sequential load whose files move down trivially
+    KeyPermutation order(FLAGS.num, stream_seed(STREAM_FILL));
+    BenchRandom rng(stream_seed(STREAM_OVERWRITE));
+    WriteOptions write_opts;
+    write_opts.disableWAL = true;
+    char key[32], value[128];
+    long long errors = 0;
 
-    ReadOptions read_opts;
-    Iterator* it = db->NewIterator(read_opts);
+    for (long long i = 0; i < FLAGS.num; ) {
+        WriteBatch batch;
+        for (int j = 0; j < BATCH_SIZE && i < FLAGS.num; j++, i++) {
+            long long idx = order(i);
+            int klen = fill_key(key, sizeof(key), idx);
+            int vlen = fill_value(value, sizeof(value), idx);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+        }
+        if (!db->Write(write_opts, &batch).ok()) errors++;
+    }
+    compact_range_phase(db, options, exclusive, 0, stream_seed(STREAM_READS),
+                        &results[0], &errors);
 
-    for (it->SeekToFirst(); it->Valid(); it->Next()) {
-        Slice key = it->key();
-        Slice value = it->value();
-        count++;
+    for (long long i = 0; i < FLAGS.num / 2; ) {
+        WriteBatch batch;
+        for (int j = 0; j < BATCH_SIZE && i < FLAGS.num / 2; j++, i++) {
+            long long idx = rng.uniform(FLAGS.num);
+            int klen = fill_key(key, sizeof(key), idx);
+            int vlen = format_value(value, sizeof(value), idx,
+                                    VERSION_OVERWRITE_BASE + (uint32_t)i);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+        }
+        if (!db->Write(write_opts, &batch).ok()) errors++;
     }
+    compact_range_phase(db, options, exclusive, 1, stream_seed(STREAM_READS) + 1,
+                        &results[1], &errors);
+    record_errors(exclusive ? "Manual CompactRange (exclusive)"
+                            : "Manual CompactRange (non-exclusive)", errors);
 
-    delete it;
+    delete db;
+    DestroyDB(path, options);
+}
 
-    end = get_time();
+static void bench_compact_range(void) {
+    print_header("BENCHMARK 17: Manual CompactRange");
+    printf("  exclusive_manual_compaction=%s, bottommost=%s\n\n",
+           FLAGS.compact_exclusive == "both" ? "true and false"
+           : FLAGS.compact_exclusive == "1" ? "true" : "false",
+           FLAGS.compact_bottommost.c_str());
 
-    print_result("Sequential scan", end - start, count);
+    if (FLAGS.compact_exclusive != "both") {
+        CompactPhaseResult results[2];
+        compact_range_run(FLAGS.compact_exclusive == "1", results);
+        return;
+    }
+
+    CompactPhaseResult excl[2], shared[2];
+    compact_range_run(true, excl);
+    compact_range_run(false, shared);
+
+    printf("  %-32s | %27s | %27s\n", "", "exclusive", "non-exclusive");
+    printf("  %-32s | %8s %9s %8s | %8s %9s %8s\n", "Phase",
+           "sec", "avg us", "p99 us", "sec", "avg us", "p99 us");
+    for (int p = 0; p < 2; p++) {
+        printf("  %-32s | %8.2f %9.2f %8.1f | %8.2f %9.2f %8.1f\n", COMPACT_PHASES[p],
+               excl[p].seconds, excl[p].read_avg_after_us, excl[p].read_p99_after_us,
+               shared[p].seconds, shared[p].read_avg_after_us, shared[p].read_p99_after_us);
+    }
+    printf("  (read latency after compaction)\n");
 }
 
-/* ==================== BENCHMARK 4: Random Updates ==================== */
-static void bench_random_updates(DB *db) {
-    print_header("BENCHMARK 4: Random Updates");
-    printf("  Updating %d random records...\n\n", NUM_UPDATES);
+/* ==================== BENCHMARK 18: WriteBatch Size Sweep ==================== */
+struct BatchSweepResult {
+    double ops_per_sec;
+    double allocs_per_batch;
+    double alloc_bytes_per_key;
+};
 
-    char key[32], value[128];
-    int i;
-    double start, end;
+/* Heap allocations behind WriteBatch's rep_ string, seen through
+** Data().capacity(): every capacity change is one reallocation. A new
+** batch's 12-byte header fits the string's inline buffer, so only
+** capacity beyond a default-constructed batch's counts. */
+struct RepGrowth {
+    const size_t inline_capacity = WriteBatch().Data().capacity();
+    size_t capacity = 0;
+    long long allocs = 0;
+    long long bytes = 0;
 
-    start = get_time();
+    void Start(const WriteBatch &batch) {
+        capacity = inline_capacity;
+        Track(batch);
+    }
 
-    WriteBatch batch;
+    void Track(const WriteBatch &batch) {
+        size_t now = batch.Data().capacity();
+        if (now != capacity) {
+            capacity = now;
+            allocs++;
+            bytes += (long long)now;
+        }
+    }
+};
 
-    for (i = 0; i < NUM_UPDATES; i++) {
-        int idx = rand() % NUM_RECORDS;
-        snprintf(key, sizeof(key), "key_%08d", idx);
-        snprintf(value, sizeof(value), "updated_value_%08d", idx);
+/* Fill a scratch DB in batches of batch_size; reuse keeps one reserved
+** WriteBatch and Clear()s it, otherwise every commit builds a new one */
+static bool run_batch_sweep_point(int batch_size, bool reuse, BatchSweepResult *r) {
+    const std::string path = FLAGS.db + "_batch";
+    Options options;
+    configure_small_db_options(options, false);
 
-        batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
+    DestroyDB(path, options);
+    DB *db = NULL;
+    Status s = DB::Open(options, path, &db);
+    if (!s.ok()) {
+        fprintf(stderr, "  Failed to open %s: %s\n", path.c_str(), s.ToString().c_str());
+        return false;
     }
 
+    char key[32], value[128];
+    long long errors = 0, batches = 0;
     WriteOptions write_opts;
-    write_opts.sync = true;  // Match SNKV's per-commit fsync
-    db->Write(write_opts, &batch);
-
-    end = get_time();
+    RepGrowth growth;
 
-    print_result("Random updates", end - start, NUM_UPDATES);
-}
+    double start = get_time();
+    // The reserve is part of the reused path's cost
+    WriteBatch reused(reuse ? fill_batch_bytes(batch_size) : 0);
+    growth.Start(reused);
+    long long i = 0;
+    auto fill_and_write = [&](WriteBatch &batch) {
+        for (int j = 0; j < batch_size && i < FLAGS.num; j++, i++) {
+            int klen = fill_key(key, sizeof(key), i);
+            int vlen = fill_value(value, sizeof(value), i);
+            batch.Put(Slice(key, klen), Slice(value, vlen));
+            growth.Track(batch);
+        }
+        if (!db->Write(write_opts, &batch).ok()) errors++;
+    };
+    for (; i < FLAGS.num; batches++) {
+        if (reuse) {
+            reused.Clear();
+            fill_and_write(reused);
+        } else {
+            WriteBatch fresh;
+            growth.Start(fresh);
+            fill_and_write(fresh);
+        }
+    }
+    double elapsed = get_time() - start;
+    record_errors("WriteBatch sweep", errors);
 
-/* ==================== BENCHMARK 5: Random Deletes ==================== */
-static void bench_random_deletes(DB *db) {
-    print_header("BENCHMARK 5: Random Deletes");
-    printf("  Deleting %d random records...\n\n", NUM_DELETES);
+    r->ops_per_sec = FLAGS.num / elapsed;
+    r->allocs_per_batch = (double)growth.allocs / batches;
+    r->alloc_bytes_per_key = (double)growth.bytes / FLAGS.num;
 
-    char key[32];
-    int i;
-    double start, end;
+    delete db;
+    DestroyDB(path, options);
+    return true;
+}
 
-    start = get_time();
+static void bench_batch_sweep(void) {
+    print_header("BENCHMARK 18: WriteBatch Size Sweep");
+    printf("  %lld keys per point, WAL on, sync=false; allocations and bytes are\n"
+           "  the WriteBatch buffer's (re)allocations, from its capacity growth\n\n",
+           FLAGS.num);
 
-    WriteBatch batch;
+    printf("  %8s | %14s %12s %10s | %14s %12s %10s\n", "batch",
+           "fresh ops/s", "allocs/batch", "B/key", "reused ops/s", "allocs/batch", "B/key");
+    for (int batch_size : FLAGS.sweep_batch_sizes) {
+        BatchSweepResult fresh, reused;
+        if (!run_batch_sweep_point(batch_size, false, &fresh) ||
+            !run_batch_sweep_point(batch_size, true, &reused)) {
+            continue;
+        }
+        char fresh_buf[32], reused_buf[32];
+        format_number((long long)fresh.ops_per_sec, fresh_buf, sizeof(fresh_buf));
+        format_number((long long)reused.ops_per_sec, reused_buf, sizeof(reused_buf));
+        printf("  %8d | %14s %12.1f %10.1f | %14s %12.1f %10.1f\n", batch_size,
+               fresh_buf, fresh.allocs_per_batch, fresh.alloc_bytes_per_key,
+               reused_buf, reused.allocs_per_batch, reused.alloc_bytes_per_key);
+        fflush(stdout);
 
-    for (i = 0; i < NUM_DELETES; i++) {
-        int idx = rand() % NUM_RECORDS;
-        snprintf(key, sizeof(key), "key_%08d", idx);
-        batch.Delete(Slice(key, strlen(key)));
+        const BatchSweepResult *modes[2] = {&fresh, &reused};
+        for (int m = 0; m < 2; m++) {
+            report_subsection(std::string("batch=") + std::to_string(batch_size) +
+                              (m ? " reused" : " fresh"));
+            report_metric("Fill", "ops/sec", modes[m]->ops_per_sec);
+            report_metric("Buffer allocations", "allocs/batch", modes[m]->allocs_per_batch);
+            report_metric("Buffer bytes", "bytes/key", modes[m]->alloc_bytes_per_key);
+        }
     }
+}
 
-    WriteOptions write_opts;
-    write_opts.sync = true;  // Match SNKV's per-commit fsync
-    db->Write(write_opts, &batch);
-
-    end = get_time();
+/* ==================== Harness Microbenchmarks ==================== */
+/* Per-op cost of the primitives every timed op goes through, set
+** against a memtable Get, the cheapest op the harness measures */
+static volatile uint64_t g_micro_sink;
 
-    print_result("Random deletes", end - start, NUM_DELETES);
+template <typename Fn>
+static double micro_ns_per_op(long long iters, Fn fn) {
+    uint64_t sink = 0;
+    double start = get_time();
+    for (long long i = 0; i < iters; i++) sink += fn(i);
+    double elapsed = get_time() - start;
+    g_micro_sink = sink;
+    return elapsed * 1e9 / iters;
 }
 
-/* ==================== BENCHMARK 6: Exists Checks ==================== */
-static void bench_exists_checks(DB *db) {
-    print_header("BENCHMARK 6: Exists Checks");
-    printf("  Checking existence of %d keys...\n\n", NUM_READS);
-
-    char key[32];
-    std::string value;
-    int i;
-    double start, end;
+/* ns per Get of a key resident in the memtable of a scratch DB */
+static double memtable_get_ns(void) {
+    const std::string path = FLAGS.db + "_micro";
+    const int keys = 10000;
+    Options options;
+    configure_small_db_options(options, false);
 
-    start = get_time();
+    DestroyDB(path, options);
+    DB *db = NULL;
+    if (!DB::Open(options, path, &db).ok()) return 0;
 
-    ReadOptions read_opts;
-    for (i = 0; i < NUM_READS; i++) {
-        int idx = rand() % NUM_RECORDS;
-        snprintf(key, sizeof(key), "key_%08d", idx);
+    WriteOptions write_opts;
+    write_opts.disableWAL = true;
+    char key[32], value[128];
+    for (int i = 0; i < keys; i++) {
+        int klen = fill_key(key, sizeof(key), i);
+        int vlen = fill_value(value, sizeof(value), i);
+        db->Put(write_opts, Slice(key, klen), Slice(value, vlen));
+    }
 
-        // Note: RocksDB has no direct "exists" API equivalent to
-        // kvstore_exists(). db->Get() reads the full value.
-        // SNKV's kvstore_exists() only checks key presence without
-        // reading the value, giving it a natural advantage here.
-        Status s = db->Get(read_opts, Slice(key, strlen(key)), &value);
+    // Keys are formatted outside the timed loop so only Get is measured
+    std::vector<std::string> lookup(keys);
+    BenchRandom rng(stream_seed(STREAM_READS));
+    for (int i = 0; i < keys; i++) {
+        int klen = fill_key(key, sizeof(key), rng.uniform(keys));
+        lookup[i].assign(key, klen);
     }
 
-    end = get_time();
+    ReadOptions read_opts;
+    std::string found;
+    double ns = micro_ns_per_op(1000000, [&](long long i) {
+        db->Get(read_opts, lookup[i % keys], &found);
+        return (uint64_t)found.size();
+    });
 
-    print_result("Exists checks", end - start, NUM_READS);
+    delete db;
+    DestroyDB(path, options);
+    return ns;
 }
 
-/* ==================== BENCHMARK 7: Mixed Workload ==================== */
-static void bench_mixed_workload(DB *db) {
-    print_header("BENCHMARK 7: Mixed Workload");
-    printf("  70%% reads, 20%% writes, 10%% deletes...\n\n");
+static int run_harness_micro(void) {
+    print_header("HARNESS MICROBENCHMARKS");
+    const long long iters = 10000000;
+    char key[32];
+    BenchRandom rng(FLAGS.seed);
+    ZipfGenerator zipf(FLAGS.num, FLAGS.zipf_theta);
+    LatencyHistogram hist;
 
-    int total_ops = 20000;
-    char key[32], value[128];
-    std::string val;
-    int i;
-    double start, end;
+    double loop = micro_ns_per_op(iters, [](long long i) { return (uint64_t)i; });
+    double keygen = micro_ns_per_op(iters, [&](long long i) {
+        return (uint64_t)fill_key(key, sizeof(key), i % FLAGS.num);
+    });
+    double prng = micro_ns_per_op(iters, [&](long long) {
+        return (uint64_t)rng.uniform(FLAGS.num);
+    });
+    double zipf_ns = micro_ns_per_op(iters, [&](long long) {
+        return (uint64_t)zipf.next(rng);
+    });
+    double record = micro_ns_per_op(iters, [&](long long i) {
+        hist.add((uint64_t)(i & 0xFFFFF));
+        return hist.total;
+    });
+    double timer = micro_ns_per_op(iters, [](long long) {
+        uint64_t t0 = now_ns();
+        return elapsed_ns(t0);
+    });
+    double get_ns = memtable_get_ns();
 
-    start = get_time();
+    struct { const char *name; double ns; } rows[] = {
+        {"Loop (baseline)", loop},
+        {"Key generation", keygen},
+        {"PRNG uniform", prng},
+        {"Zipf sample", zipf_ns},
+        {"Histogram record", record},
+        {"Timer pair", timer},
+    };
 
-    WriteBatch batch;
-    WriteOptions write_opts;
-    write_opts.sync = true;  // Match SNKV's per-commit fsync
-    ReadOptions read_opts;
+    print_timer();
+    printf("  Memtable Get: %.1f ns/op\n\n", get_ns);
+    printf("  %-20s %10s %14s\n", "Primitive", "ns/op", "% of Get");
+    for (const auto &r : rows) {
+        printf("  %-20s %10.2f %13.1f%%\n", r.name, r.ns,
+               get_ns > 0 ? 100.0 * r.ns / get_ns : 0.0);
+    }
 
-    for (i = 0; i < total_ops; i++) {
-        int idx = rand() % NUM_RECORDS;
-        int op = rand() % 100;
+    // What one timed random Get pays on top of RocksDB itself
+    double per_op = keygen + prng + record + timer;
+    double pct = get_ns > 0 ? 100.0 * per_op / get_ns : 0.0;
+    printf("\n  %-30s: %s%.1f ns (%.1f%% of a memtable Get)" COLOR_RESET "\n",
+           "Per-op harness cost", pct > 5.0 ? COLOR_YELLOW : COLOR_GREEN, per_op, pct);
+    return 0;
+}
 
-        snprintf(key, sizeof(key), "key_%08d", idx);
+/* ==================== Verification ==================== */
+/* Rebuild the expected final version of every key by replaying the
+** mutating benchmarks' random streams without touching the DB. Must
+** mirror the draws made by those benchmarks exactly. Assumes the DB
+** started from a complete load (fresh, or a restored checkpoint).
+** Only needed when the live shadow model was not kept. */
+static void build_expected_state(ExpectedState *expected) {
+    const long long num = FLAGS.num;
 
-        if (op < 70) {
-            /* Read */
-            db->Get(read_opts, Slice(key, strlen(key)), &val);
-        } else if (op < 90) {
-            /* Write */
-            snprintf(value, sizeof(value), "mixed_value_%08d", idx);
-            batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
-        } else {
-            /* Delete */
-            batch.Delete(Slice(key, strlen(key)));
-        }
+    BenchRandom updates(stream_seed(STREAM_UPDATES));
+    for (int i = 0; i < NUM_UPDATES; i++) {
+        expected->Put(updates.uniform(num), VERSION_UPDATED);
+    }
 
-        // Flush batch periodically (every 100 write ops, matching commit cadence)
-        if (batch.Count() > 100) {
-            db->Write(write_opts, &batch);
-            batch.Clear();
+    BenchRandom deletes(stream_seed(STREAM_DELETES));
+    for (int i = 0; i < NUM_DELETES; i++) {
+        expected->Delete(deletes.uniform(num));
+    }
+
+    BenchRandom mixed(stream_seed(STREAM_MIXED));
+    for (int i = 0; i < NUM_MIXED_OPS; i++) {
+        long long idx = mixed.uniform(num);
+        int op = (int)mixed.uniform(100);
+        if (op >= 90) {
+            expected->Delete(idx);
+        } else if (op >= 70) {
+            expected->Put(idx, VERSION_MIXED);
         }
     }
 
-    // Flush remaining operations
-    if (batch.Count() > 0) {
-        db->Write(write_opts, &batch);
+    if (FLAGS.overwrite_ops > 0) {
+        const long long ws_keys =
+            std::max(1LL, (long long)(num * FLAGS.overwrite_working_set));
+        KeyPermutation scatter(num, stream_seed(STREAM_OVERWRITE_SCATTER));
+        BenchRandom rng(stream_seed(STREAM_OVERWRITE));
+        for (long long i = 0; i < FLAGS.overwrite_ops; i++) {
+            expected->Put(scatter(rng.uniform(ws_keys)), VERSION_OVERWRITE_BASE + (uint32_t)i);
+        }
     }
+}
 
-    end = get_time();
+struct VerifyCounts {
+    std::atomic<long long> checked{0};
+    std::atomic<long long> missing{0};
+    std::atomic<long long> unexpected{0};
+    std::atomic<long long> wrong_value{0};
+    std::atomic<long long> errors{0};
+    std::mutex report_mu;
+    int reported = 0;
+};
 
-    print_result("Mixed workload", end - start, total_ops);
+static void report_mismatch(VerifyCounts *counts, const char *what, long long idx) {
+    std::lock_guard<std::mutex> lock(counts->report_mu);
+    if (counts->reported++ < 10) {
+        printf("    " COLOR_YELLOW "%s" COLOR_RESET ": key_%0*lld\n", what,
+               FLAGS.key_width, idx);
+    }
 }
 
-/* ==================== BENCHMARK 8: Bulk Insert ==================== */
-static void bench_bulk_insert(void) {
-    print_header("BENCHMARK 8: Bulk Insert (Single Transaction)");
-    printf("  Inserting %d records in one transaction...\n\n", NUM_RECORDS);
+/* Check [first, last) with MultiGet in batches of verify_batch keys */
+static void verify_range(DB *db, const ExpectedState *expected,
+                         long long first, long long last, VerifyCounts *counts) {
+    const int verify_batch = 128;
+    char keys[verify_batch][32];
+    char value[128];
+    Slice key_slices[verify_batch];
+    PinnableSlice values[verify_batch];
+    Status statuses[verify_batch];
+    ReadOptions read_opts;
+    read_opts.fill_cache = false;  // Don't let the verifier evict hot blocks
 
-    char key[32], value[128];
-    int i;
-    double start, end;
+    for (long long base = first; base < last; base += verify_batch) {
+        int n = (int)std::min<long long>(verify_batch, last - base);
+        for (int k = 0; k < n; k++) {
+            int klen = fill_key(keys[k], sizeof(keys[k]), base + k);
+            key_slices[k] = Slice(keys[k], klen);
+            values[k].Reset();
+        }
 
-    // Open separate database for this test
-    Options options;
-    configure_small_db_options(options);
+        db->MultiGet(read_opts, db->DefaultColumnFamily(), n, key_slices, values, statuses);
 
-    DB* db;
-    Status status = DB::Open(options, "benchmark_bulk_rocksdb", &db);
-    if (!status.ok()) {
-        fprintf(stderr, "Failed to open database for bulk insert\n");
-        return;
+        for (int k = 0; k < n; k++) {
+            long long idx = base + k;
+            if (read_failed(statuses[k])) {
+                counts->errors.fetch_add(1, std::memory_order_relaxed);
+                report_mismatch(counts, "read error", idx);
+            } else if (!expected->Exists(idx)) {
+                if (statuses[k].ok()) {
+                    counts->unexpected.fetch_add(1, std::memory_order_relaxed);
+                    report_mismatch(counts, "deleted key present", idx);
+                }
+            } else if (statuses[k].IsNotFound()) {
+                counts->missing.fetch_add(1, std::memory_order_relaxed);
+                report_mismatch(counts, "missing key", idx);
+            } else {
+                int vlen = format_value(value, sizeof(value), idx, expected->Version(idx));
+                if (!(values[k] == Slice(value, vlen))) {
+                    counts->wrong_value.fetch_add(1, std::memory_order_relaxed);
+                    report_mismatch(counts, "wrong value", idx);
+                }
+            }
+        }
+        counts->checked.fetch_add(n, std::memory_order_relaxed);
     }
+}
 
-    start = get_time();
-
-    WriteBatch batch;
-
-    for (i = 0; i < NUM_RECORDS; i++) {
-        snprintf(key, sizeof(key), "bulk_key_%08d", i);
-        snprintf(value, sizeof(value), "bulk_value_%08d", i);
-        batch.Put(Slice(key, strlen(key)), Slice(value, strlen(value)));
+static void verify_db(DB *db) {
+    print_header("VERIFICATION: Full Key/Value Check");
+    if (FLAGS.use_existing_db) {
+        printf("  Restored checkpoint assumed to hold a fresh load of %lld keys\n", FLAGS.num);
     }
 
-    WriteOptions write_opts;
-    write_opts.sync = true;  // Match SNKV's per-commit fsync
-    db->Write(write_opts, &batch);
-
-    end = get_time();
+    std::unique_ptr<ExpectedState> replayed;
+    const ExpectedState *expected = g_shadow;
+    double start = get_time();
+    if (expected) {
+        printf("  Using live shadow model\n");
+    } else {
+        replayed.reset(new ExpectedState(FLAGS.num, VERSION_LOADED));
+        build_expected_state(replayed.get());
+        expected = replayed.get();
+        printf("  Rebuilt expected state from seed %llu in %.2f seconds\n",
+               (unsigned long long)FLAGS.seed, get_time() - start);
+    }
+    printf("  Checking %lld keys with %d threads...\n\n", FLAGS.num, FLAGS.verify_threads);
 
-    delete db;
+    VerifyCounts counts;
+    std::vector<std::thread> threads;
 
-    // Cleanup
-    DestroyDB("benchmark_bulk_rocksdb", options);
+    start = get_time();
+    for (int t = 0; t < FLAGS.verify_threads; t++) {
+        long long first = FLAGS.num * t / FLAGS.verify_threads;
+        long long last = FLAGS.num * (t + 1) / FLAGS.verify_threads;
+        threads.emplace_back(verify_range, db, expected, first, last, &counts);
+    }
+    for (auto &th : threads) th.join();
+    double end = get_time();
 
-    print_result("Bulk insert", end - start, NUM_RECORDS);
+    long long failures = counts.missing + counts.unexpected + counts.wrong_value;
+    print_result("Verification", end - start, counts.checked.load());
+    record_errors("Verification", counts.errors.load());
+    if (failures == 0 && counts.errors == 0) {
+        printf("  %-30s: " COLOR_GREEN "all keys match" COLOR_RESET "\n", "Result");
+    } else {
+        printf("  %-30s: " COLOR_YELLOW "%lld mismatches" COLOR_RESET
+               " (%lld missing, %lld unexpected, %lld wrong value)\n", "Result",
+               failures, counts.missing.load(), counts.unexpected.load(),
+               counts.wrong_value.load());
+    }
 }
 
 /* ==================== Main ==================== */
-int main(void) {
+int main(int argc, char **argv) {
     DB *db = NULL;
     double total_start, total_end;
     long mem_start, mem_end, mem_peak;
     char mem_buf[64];
 
+    if (!parse_flags(argc, argv)) {
+        return 1;
+    }
+    if (FLAGS.replica_primary) {
+        return run_replica_primary();
+    }
+    init_timer();
+    if (!FLAGS.report.empty()) {
+        g_report = fopen(FLAGS.report.c_str(), "w");
+        if (!g_report) {
+            fprintf(stderr, "Cannot open --report file %s\n", FLAGS.report.c_str());
+            return 1;
+        }
+    }
+    if (FLAGS.harness_micro) {
+        return run_harness_micro();
+    }
+
     printf("\n");
     printf(COLOR_BLUE "╔══════════════════════════════════════════════════════════════╗\n");
     printf("║          RocksDB Performance Benchmark (Small DB)           ║\n");
     printf("║                                                              ║\n");
-    printf("║  Database: %-50s║\n", DB_FILE);
-    printf("║  Records:  %-50d║\n", NUM_RECORDS);
+    printf("║  Database: %-50s║\n", FLAGS.db.c_str());
+    printf("║  Records:  %-50lld║\n", FLAGS.num);
     printf("╚══════════════════════════════════════════════════════════════╝\n");
     printf(COLOR_RESET);
-
-    srand(time(NULL));
+    printf("  Seed: %llu (reproduce with --seed=%llu)\n",
+           (unsigned long long)FLAGS.seed, (unsigned long long)FLAGS.seed);
+    print_build_info();
+    print_environment();
+    printf("  Allocator: %s\n", get_heap_stats().allocator);
+    print_timer();
 
     /* Measure initial memory */
     mem_start = get_memory_usage();
@@ -463,15 +4323,37 @@ int main(void) {
     Options options;
     configure_small_db_options(options);
 
-    // Cleanup existing database
-    DestroyDB(DB_FILE, options);
+    if (FLAGS.use_existing_db) {
+        // Never create an empty DB in place of the expected dataset
+        options.create_if_missing = false;
+        if (!FLAGS.restore_checkpoint.empty() &&
+            !restore_checkpoint(FLAGS.restore_checkpoint, FLAGS.db, options)) {
+            return 1;
+        }
+        if (!check_key_width(FLAGS.db)) return 1;
+    } else {
+        // Cleanup existing database
+        remove(key_width_path(FLAGS.db).c_str());
+        DestroyDB(FLAGS.db, options);
+    }
 
-    Status status = DB::Open(options, DB_FILE, &db);
+    options.enable_thread_tracking = FLAGS.thread_status;
+    Status status = DB::Open(options, FLAGS.db, &db);
     if (!status.ok()) {
         fprintf(stderr, "Failed to open RocksDB: %s\n", status.ToString().c_str());
         return 1;
     }
 
+    ThreadStatusSampler thread_sampler;
+    if (FLAGS.thread_status) {
+        if (thread_sampler.Start()) {
+            g_thread_sampler = &thread_sampler;
+        } else {
+            printf("  " COLOR_YELLOW "Thread status is not supported by this RocksDB build"
+                   COLOR_RESET "\n");
+        }
+    }
+
     long mem_after_open = get_memory_usage();
     format_memory(mem_after_open - mem_start, mem_buf, sizeof(mem_buf));
     printf("  Memory after opening DB: %s\n", mem_buf);
@@ -480,19 +4362,73 @@ int main(void) {
     mem_peak = mem_after_open;
 
     /* Run benchmarks */
-    bench_sequential_writes(db);
+    if (FLAGS.use_existing_db) {
+        printf("\n  Using existing database, skipping load "
+               "(rocksdb.estimate-num-keys: %llu)\n",
+               (unsigned long long)get_int_property(db, "rocksdb.estimate-num-keys"));
+    } else {
+        if (FLAGS.loader == "serial") {
+            bench_sequential_writes(db, options.statistics.get());
+        } else {
+            bench_parallel_load(db, options);
+        }
+        write_key_width(FLAGS.db);
+        if (!FLAGS.save_checkpoint.empty()) {
+            save_checkpoint(db, FLAGS.save_checkpoint);
+        }
+        dump_phase_properties(db, options);
+    }
+
+    // Every load path writes each key once with its loaded value
+    std::unique_ptr<ExpectedState> shadow;
+    if (FLAGS.shadow_model) {
+        shadow.reset(new ExpectedState(FLAGS.num, VERSION_LOADED));
+        g_shadow = shadow.get();
+        format_memory((long)(shadow->MemoryBytes() / 1024), mem_buf, sizeof(mem_buf));
+        printf("\n  Shadow model: %s for %lld keys%s\n", mem_buf, FLAGS.num,
+               FLAGS.verify_reads ? ", verifying every read" : "");
+    }
     long mem_after_writes = get_memory_usage();
     if (mem_after_writes > mem_peak) mem_peak = mem_after_writes;
 
-    bench_random_reads(db);
+    double fresh_read_ops = bench_random_reads(db);
+    dump_phase_properties(db, options);
+    if (FLAGS.steady_state != "none") {
+        bench_random_reads_steady(db, fresh_read_ops);
+        dump_phase_properties(db, options);
+    }
     long mem_after_reads = get_memory_usage();
     if (mem_after_reads > mem_peak) mem_peak = mem_after_reads;
 
+    // A reused DB without a checkpoint to fall back on is kept as loaded
+    bool run_writes = !FLAGS.use_existing_db || !FLAGS.restore_checkpoint.empty() ||
+                      FLAGS.reuse_writes;
+
     bench_sequential_scan(db);
-    bench_random_updates(db);
-    bench_random_deletes(db);
+    dump_phase_properties(db, options);
+    if (run_writes) {
+        bench_random_updates(db);
+        dump_phase_properties(db, options);
+        bench_random_deletes(db);
+        dump_phase_properties(db, options);
+    }
     bench_exists_checks(db);
-    bench_mixed_workload(db);
+    dump_phase_properties(db, options);
+    if (run_writes) {
+        bench_mixed_workload(db);
+        dump_phase_properties(db, options);
+        if (FLAGS.overwrite_ops > 0) {
+            bench_overwrite(db, options.statistics.get());
+            dump_phase_properties(db, options);
+        }
+    } else {
+        printf("\n  Reused DB without --restore_checkpoint: skipping updates, deletes,\n"
+               "  mixed workload and overwrite (--reuse_writes=1 runs them)\n");
+    }
+    if (FLAGS.verify) {
+        verify_db(db);
+        dump_phase_properties(db, options);
+    }
 
     mem_end = get_memory_usage();
     if (mem_end > mem_peak) mem_peak = mem_end;
@@ -531,10 +4467,44 @@ int main(void) {
     printf("    - Table readers:   %s\n", mem_buf);
     format_memory((cache_mem + memtable_mem + table_readers_mem) / 1024, mem_buf, sizeof(mem_buf));
     printf("    - Total internal:  %s\n", mem_buf);
+    print_heap_stats();
 
+    thread_sampler.Stop();
+    g_thread_sampler = NULL;
     delete db;
 
-    bench_bulk_insert();
+    if (FLAGS.async_bench) {
+        bench_async_multiget(options);
+    }
+    if (FLAGS.prefix_bench) {
+        bench_prefix_workload();
+    }
+    if (FLAGS.cuckoo_bench) {
+        bench_readonly_formats();
+    }
+    if (FLAGS.replica_bench) {
+        bench_replicas();
+    }
+    if (FLAGS.block_sweep) {
+        bench_block_sweep();
+    }
+    if (FLAGS.tiered_bench) {
+        bench_tiered_placement();
+    }
+    if (FLAGS.periodic_bench) {
+        bench_periodic_compaction();
+    }
+    if (FLAGS.compact_bench) {
+        bench_compact_range();
+    }
+    if (FLAGS.batch_sweep) {
+        bench_batch_sweep();
+    }
+
+    // Bulk insert is a load test of its own; it has no place in a reuse run
+    if (!FLAGS.use_existing_db) {
+        bench_bulk_insert();
+    }
 
     total_end = get_time();
 
@@ -546,6 +4516,9 @@ int main(void) {
     printf(COLOR_RESET);
     printf("  Total benchmark time: " COLOR_GREEN "%.2f seconds" COLOR_RESET "\n",
            total_end - total_start);
+    g_report_section = "SUMMARY";
+    report_metric("Total benchmark time", "sec", total_end - total_start);
+    print_status_errors();
 
     printf("\n");
     printf("  Process Memory Usage:\n");
@@ -557,11 +4530,18 @@ int main(void) {
     printf("    - Peak:     %s\n", mem_buf);
     format_memory(mem_end - mem_start, mem_buf, sizeof(mem_buf));
     printf("    - Delta:    %s\n", mem_buf);
+    print_heap_stats();
+
+    print_full_options(options);
 
     printf("\n" COLOR_GREEN "✓ Benchmark complete!" COLOR_RESET "\n\n");
+    if (g_report) fclose(g_report);
 
-    /* Cleanup */
-    DestroyDB(DB_FILE, options);
+    /* Cleanup (an existing DB is left for the next run) */
+    if (!FLAGS.use_existing_db) {
+        remove(key_width_path(FLAGS.db).c_str());
+        DestroyDB(FLAGS.db, options);
+    }
 
     return 0;
 }